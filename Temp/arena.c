@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/*
+ * novoBloco - Pede um bloco ao malloc com pelo menos 'minimo' bytes uteis
+ */
+static BlocoArena* novoBloco(Arena *arena, size_t minimo) {
+    size_t capacidade = ARENA_TAM_BLOCO;
+    if (minimo > capacidade) {
+        capacidade = minimo;  /* Pedido grande ganha um bloco exclusivo */
+    }
+
+    /* O cabecalho fica no inicio; os dados comecam no proximo multiplo do alinhamento */
+    size_t cabecalho = (sizeof(BlocoArena) + ARENA_ALINHAMENTO - 1) & ~(size_t)(ARENA_ALINHAMENTO - 1);
+    BlocoArena *bloco = (BlocoArena*) malloc(cabecalho + capacidade);
+    if (bloco == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a arena\n");
+        exit(1);
+    }
+
+    bloco->anterior = arena->atual;
+    bloco->usado = 0;
+    bloco->capacidade = capacidade;
+    bloco->dados = (char*) bloco + cabecalho;
+
+    arena->atual = bloco;
+    arena->numBlocos++;
+    arena->bytesReservados += capacidade;
+    return bloco;
+}
+
+void* arenaAlocar(Arena *arena, size_t tamanho) {
+    /* Arredonda para manter o proximo ponteiro alinhado */
+    size_t ajustado = (tamanho + ARENA_ALINHAMENTO - 1) & ~(size_t)(ARENA_ALINHAMENTO - 1);
+    if (ajustado == 0) {
+        ajustado = ARENA_ALINHAMENTO;
+    }
+
+    BlocoArena *bloco = arena->atual;
+    if (bloco == NULL || bloco->capacidade - bloco->usado < ajustado) {
+        bloco = novoBloco(arena, ajustado);
+    }
+
+    void *p = bloco->dados + bloco->usado;
+    bloco->usado += ajustado;
+
+    arena->numAlocacoes++;
+    arena->bytesAlocados += tamanho;
+    return p;
+}
+
+char* arenaStrndup(Arena *arena, const char *s, size_t n) {
+    char *copia = (char*) arenaAlocar(arena, n + 1);
+    memcpy(copia, s, n);
+    copia[n] = '\0';
+    return copia;
+}
+
+/*
+ * arenaLiberar - Devolve todos os blocos de uma vez (liberacao em massa)
+ */
+void arenaLiberar(Arena *arena) {
+    BlocoArena *bloco = arena->atual;
+    while (bloco != NULL) {
+        BlocoArena *anterior = bloco->anterior;
+        free(bloco);
+        bloco = anterior;
+    }
+    arena->atual = NULL;
+}
+
+/*
+ * arenaIncorporar - Encadeia os blocos de outra arena nesta, sem copiar nada.
+ * As proximas alocacoes de 'destino' usam o bloco mais novo de 'origem'.
+ */
+void arenaIncorporar(Arena *destino, Arena *origem) {
+    if (origem->atual != NULL) {
+        BlocoArena *maisAntigo = origem->atual;
+        while (maisAntigo->anterior != NULL) {
+            maisAntigo = maisAntigo->anterior;
+        }
+        maisAntigo->anterior = destino->atual;
+        destino->atual = origem->atual;
+    }
+
+    destino->numAlocacoes += origem->numAlocacoes;
+    destino->bytesAlocados += origem->bytesAlocados;
+    destino->numBlocos += origem->numBlocos;
+    destino->bytesReservados += origem->bytesReservados;
+
+    origem->atual = NULL;
+    origem->numAlocacoes = 0;
+    origem->bytesAlocados = 0;
+    origem->numBlocos = 0;
+    origem->bytesReservados = 0;
+}
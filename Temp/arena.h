@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* Tamanho padrao de cada bloco pedido ao malloc */
+#define ARENA_TAM_BLOCO (64 * 1024)
+
+/* Alinhamento garantido para toda alocacao da arena */
+#define ARENA_ALINHAMENTO 16
+
+typedef struct BlocoArena {
+    struct BlocoArena *anterior;  /* Bloco preenchido antes deste */
+    size_t usado;                 /* Bytes ja entregues */
+    size_t capacidade;            /* Bytes disponiveis em dados */
+    char *dados;                  /* Inicio da area util (alinhada) */
+} BlocoArena;
+
+typedef struct {
+    BlocoArena *atual;            /* Bloco onde as alocacoes acontecem */
+    size_t numAlocacoes;          /* Pedidos atendidos (mallocs evitados) */
+    size_t bytesAlocados;         /* Soma dos tamanhos pedidos */
+    size_t numBlocos;             /* Blocos obtidos com malloc */
+    size_t bytesReservados;       /* Memoria total reservada nos blocos */
+} Arena;
+
+/* Arena vazia, pronta para uso */
+#define ARENA_INICIAL { NULL, 0, 0, 0, 0 }
+
+void* arenaAlocar(Arena *arena, size_t tamanho);
+
+char* arenaStrndup(Arena *arena, const char *s, size_t n);
+
+void arenaLiberar(Arena *arena);
+
+/* Passa os blocos de 'origem' para 'destino' (que passa a libera-los) */
+void arenaIncorporar(Arena *destino, Arena *origem);
+
+#endif
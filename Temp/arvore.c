@@ -1,79 +1,390 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
 #include "arvore.h"
+#include "contexto.h"
 
-NoArvore* criarNo(const char* tipo, const char* valor, int linha) {
-    /* Aloca memoria para o no */
-    NoArvore* no = (NoArvore*) malloc(sizeof(NoArvore));
-    if (!no) {
-        fprintf(stderr, "Erro de alocacao de memoria para NoArvore\n");
+/* Nomes imprimiveis, na mesma ordem do enum TipoNo */
+static const char* const nomesTipoNo[NUM_TIPOS_NO] = {
+    "DECL_LIST", "DECL", "VAR", "ARRAY_VAR", "TAM", "TIPO", "FUN_DEF",
+    "PARAMS", "PARAM_LIST", "PARAM", "PARAM_ARRAY", "CORPO",
+    "CMD_LIST", "CMD_LIST_VAZIA", "CMD", "BLOCO", "BLOCO_VAZIO",
+    "EXP_CMD", "EXP_CMD_VAZIO", "IF", "IFELSE", "WHILE", "RETURN",
+    "ATRIB", "REL", "OP", "SOMA", "SUB", "MULT", "DIV", "NUM",
+    "CHAMADA_FUNCAO", "ARGS", "ID", "ID_ARRAY"
+};
+
+/* Soma dos campos de um no, um em cada vetor do bloco */
+#define BYTES_POR_NO_BLOCO (2 * sizeof(NoId) + sizeof(Atomo) + sizeof(unsigned int) + 1)
+
+/* Anotacoes reservadas pela analise semantica para cada no: o simbolo
+   e o TipoDado */
+#define BYTES_POR_ANOTACAO (sizeof(struct Simbolo*) + 1)
+
+const char* nomeTipoNo(TipoNo tipo) {
+    return nomesTipoNo[tipo];
+}
+
+/*
+ * crescerArvore - Dobra a capacidade, copiando cada vetor para a sua fatia
+ * no bloco novo
+ */
+static void crescerArvore(Arvore *a) {
+    unsigned int capacidade = a->capacidade ? a->capacidade * 2 : 1024;
+    size_t n = (size_t) capacidade;
+    char *bloco = (char*) malloc(n * BYTES_POR_NO_BLOCO);
+    if (bloco == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a arvore sintatica\n");
         exit(1);
     }
     
-    /* Copia o tipo (usa strncpy para seguranca) */
-    strncpy(no->tipo, tipo, sizeof(no->tipo) - 1);
-    no->tipo[sizeof(no->tipo) - 1] = '\0';
-
-    /* Copia o valor (se fornecido) */
-    if (valor != NULL) {
-        strncpy(no->valor, valor, sizeof(no->valor) - 1);
-        no->valor[sizeof(no->valor) - 1] = '\0';
-    } else {
-        no->valor[0] = '\0';  /* String vazia */
+    /* Vetores de 4 bytes primeiro, o de tipos (1 byte) no fim */
+    NoId *primeiroFilho = (NoId*) bloco;
+    NoId *proximoIrmao = primeiroFilho + n;
+    Atomo *valores = (Atomo*) (proximoIrmao + n);
+    unsigned int *linhas = (unsigned int*) (valores + n);
+    unsigned char *tipos = (unsigned char*) (linhas + n);
+    
+    if (a->total > 0) {
+        size_t usados = (size_t) a->total;
+        memcpy(primeiroFilho, a->primeiroFilho, usados * sizeof(NoId));
+        memcpy(proximoIrmao, a->proximoIrmao, usados * sizeof(NoId));
+        memcpy(valores, a->valores, usados * sizeof(Atomo));
+        memcpy(linhas, a->linhas, usados * sizeof(unsigned int));
+        memcpy(tipos, a->tipos, usados);
     }
-
-    /* Inicializa outros campos */
-    no->linha = linha;
-    no->nFilhos = 0;
+    free(a->bloco);
     
-    /* Inicializa todos os ponteiros de filhos como NULL */
-    for (int i = 0; i < MAX_FILHOS; i++) {
-        no->filhos[i] = NULL;
+    a->bloco = bloco;
+    a->primeiroFilho = primeiroFilho;
+    a->proximoIrmao = proximoIrmao;
+    a->valores = valores;
+    a->linhas = linhas;
+    a->tipos = tipos;
+    a->capacidade = capacidade;
+}
+
+NoId criarNo(ContextoCompilador *ctx, TipoNo tipo, Atomo valor, int linha) {
+    Arvore *a = &ctx->arvore;
+    if (a->total == 0) {
+        /* O indice 0 fica reservado para NO_NULO */
+        crescerArvore(a);
+        a->primeiroFilho[0] = NO_NULO;
+        a->proximoIrmao[0] = NO_NULO;
+        a->valores[0] = ATOMO_NULO;
+        a->linhas[0] = 0;
+        a->tipos[0] = 0;
+        a->total = 1;
+    } else if (a->total == a->capacidade) {
+        crescerArvore(a);
     }
     
+    NoId no = a->total++;
+    a->tipos[no] = (unsigned char) tipo;
+    a->valores[no] = valor;
+    a->linhas[no] = (unsigned int) linha;
+    a->primeiroFilho[no] = NO_NULO;
+    a->proximoIrmao[no] = NO_NULO;
     return no;
 }
 
-void adicionarFilho(NoArvore* pai, NoArvore* filho) {
-    /* Verifica se os ponteiros sao validos */
-    if (pai == NULL || filho == NULL) {
-        return;
+NoId criarNoComFilhos(ContextoCompilador *ctx, TipoNo tipo, Atomo valor, int linha,
+                      int nFilhos, ...) {
+    NoId no = criarNo(ctx, tipo, valor, linha);
+    Arvore *a = &ctx->arvore;
+    NoId anterior = NO_NULO;
+    
+    va_list args;
+    va_start(args, nFilhos);
+    for (int i = 0; i < nFilhos; i++) {
+        NoId filho = va_arg(args, NoId);
+        if (filho == NO_NULO) {
+            continue;
+        }
+        if (anterior == NO_NULO) {
+            a->primeiroFilho[no] = filho;
+        } else {
+            a->proximoIrmao[anterior] = filho;
+        }
+        anterior = filho;
+    }
+    va_end(args);
+    return no;
+}
+
+NoId criarNum(ContextoCompilador *ctx, int valor, int linha) {
+    return criarNo(ctx, NO_NUM, (Atomo) valor, linha);
+}
+
+/* Devolve o no ao fim da arvore se ele foi o ultimo criado */
+static void descartarNo(Arvore *a, NoId no) {
+    if (no != NO_NULO && no == a->total - 1) {
+        a->total--;
+    }
+}
+
+/*
+ * dobrarLiteral - Troca 'esq' (um NUM) pelo resultado e descarta os nos dos
+ * outros operandos, criados depois dele
+ */
+static NoId dobrarLiteral(ContextoCompilador *ctx, NoId esq, NoId op, NoId dir, int valor) {
+    ctx->arvore.valores[esq] = (Atomo) valor;
+    descartarNo(&ctx->arvore, dir);
+    descartarNo(&ctx->arvore, op);
+    return esq;
+}
+
+NoId criarOperacao(ContextoCompilador *ctx, TipoNo tipo, Atomo operador, int linha,
+                   NoId esq, NoId dir) {
+    const Arvore *a = &ctx->arvore;
+    if (esq == NO_NULO || dir == NO_NULO || tipoNo(a, esq) != NO_NUM || tipoNo(a, dir) != NO_NUM) {
+        return criarNoComFilhos(ctx, tipo, operador, linha, 2, esq, dir);
     }
     
-    /* Verifica se ainda ha espaco para mais filhos */
-    if (pai->nFilhos < MAX_FILHOS) {
-        pai->filhos[pai->nFilhos] = filho;
-        pai->nFilhos++;
-    } else {
-        fprintf(stderr, "Aviso: numero maximo de filhos excedido\n");
+    /* Aritmetica de 32 bits com volta (sem comportamento indefinido) */
+    unsigned int x = (unsigned int) valorLiteral(a, esq);
+    unsigned int y = (unsigned int) valorLiteral(a, dir);
+    unsigned int r;
+    switch (tipo) {
+    case NO_SOMA: r = x + y; break;
+    case NO_SUB:  r = x - y; break;
+    case NO_MULT: r = x * y; break;
+    default:
+        if (y == 0) {
+            return criarNoComFilhos(ctx, tipo, operador, linha, 2, esq, dir);
+        }
+        if ((int) y == -1) {
+            r = 0u - x;
+        } else {
+            r = (unsigned int) ((int) x / (int) y);
+        }
+        break;
+    }
+    return dobrarLiteral(ctx, esq, NO_NULO, dir, (int) r);
+}
+
+NoId criarRelacional(ContextoCompilador *ctx, int linha, NoId esq, NoId op, NoId dir) {
+    const Arvore *a = &ctx->arvore;
+    if (esq == NO_NULO || dir == NO_NULO || tipoNo(a, esq) != NO_NUM || tipoNo(a, dir) != NO_NUM) {
+        return criarNoComFilhos(ctx, NO_REL, ATOMO_NULO, linha, 3, esq, op, dir);
     }
+    
+    int x = valorLiteral(a, esq);
+    int y = valorLiteral(a, dir);
+    int r;
+    switch (valorNo(a, op)) {
+    case ATOMO_MENOR:      r = x < y; break;
+    case ATOMO_MAIOR:      r = x > y; break;
+    case ATOMO_MENORIGUAL: r = x <= y; break;
+    case ATOMO_MAIORIGUAL: r = x >= y; break;
+    case ATOMO_IGUAL:      r = x == y; break;
+    default:               r = x != y; break;
+    }
+    return dobrarLiteral(ctx, esq, op, dir, r);
 }
 
-void imprimirArvore(NoArvore* no, int nivel) {
-    /* Caso base: no nulo */
-    if (no == NULL) {
+void adicionarFilho(ContextoCompilador *ctx, NoId pai, NoId filho) {
+    if (pai == NO_NULO || filho == NO_NULO) {
         return;
     }
     
-    /* Imprime indentacao (2 espacos por nivel) */
-    for (int i = 0; i < nivel; i++) {
-        printf("  ");
+    /* O valor do no de lista aponta o ultimo item ate fecharLista */
+    Arvore *a = &ctx->arvore;
+    NoId ultimo = a->valores[pai];
+    if (ultimo == NO_NULO) {
+        a->primeiroFilho[pai] = filho;
+    } else {
+        a->proximoIrmao[ultimo] = filho;
+    }
+    a->valores[pai] = filho;
+}
+
+void reservarAnotacoes(Arvore *a) {
+    size_t n = a->total > 0 ? a->total : 1;
+    free(a->simbolos);
+    free(a->tiposDado);
+    a->simbolos = (struct Simbolo**) calloc(n, sizeof(struct Simbolo*));
+    a->tiposDado = (unsigned char*) calloc(n, 1);
+    if (a->simbolos == NULL || a->tiposDado == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para os simbolos da arvore\n");
+        exit(1);
+    }
+}
+
+void fecharLista(ContextoCompilador *ctx, NoId lista) {
+    if (lista != NO_NULO) {
+        ctx->arvore.valores[lista] = ATOMO_NULO;
+    }
+}
+
+NoId* coletarDeclaracoes(const Arvore *a, NoId raiz, int *total) {
+    /* O programa e uma DECL_LIST plana com uma declaracao por filho */
+    int n = tipoNo(a, raiz) == NO_DECL_LIST ? numFilhos(a, raiz) : 1;
+    NoId *decls = (NoId*) malloc(sizeof(NoId) * (size_t) (n > 0 ? n : 1));
+    if (decls == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para as declaracoes\n");
+        exit(1);
+    }
+
+    NoId decl = tipoNo(a, raiz) == NO_DECL_LIST ? primeiroFilho(a, raiz) : raiz;
+    for (int i = 0; i < n; i++, decl = proximoIrmao(a, decl)) {
+        decls[i] = decl;
+    }
+    *total = n;
+    return decls;
+}
+
+void* empilhar(PilhaPercurso *p) {
+    if (p->total == p->capacidade) {
+        p->capacidade = p->capacidade ? p->capacidade * 2 : 256;
+        p->quadros = (char*) realloc(p->quadros, p->tamQuadro * p->capacidade);
+        if (p->quadros == NULL) {
+            fprintf(stderr, "Erro de alocacao de memoria para o percurso da arvore\n");
+            exit(1);
+        }
+    }
+    void *quadro = p->quadros + p->tamQuadro * p->total++;
+    memset(quadro, 0, p->tamQuadro);
+    return quadro;
+}
+
+void* desempilhar(PilhaPercurso *p) {
+    return p->quadros + p->tamQuadro * --p->total;
+}
+
+void* quadroPilha(PilhaPercurso *p, size_t i) {
+    return p->quadros + p->tamQuadro * i;
+}
+
+void liberarPilha(PilhaPercurso *p) {
+    free(p->quadros);
+    p->quadros = NULL;
+    p->total = 0;
+    p->capacidade = 0;
+}
+
+/* Quadro do percurso de impressao */
+typedef struct {
+    NoId no;
+    int nivel;
+    TipoNo pai;           /* Tipo do pai (NUM_TIPOS_NO na raiz) */
+} QuadroImpressao;
+
+static void empilharQuadroImpressao(PilhaPercurso *pilha, NoId no, int nivel, TipoNo pai) {
+    QuadroImpressao *q = (QuadroImpressao*) empilhar(pilha);
+    q->no = no;
+    q->nivel = nivel;
+    q->pai = pai;
+}
+
+/*
+ * involucroDetalhado - No que o parser antigo punha em volta de 'tipo' sob
+ * um pai 'pai' (NUM_TIPOS_NO se nenhum): DECL em cada item das listas de
+ * declaracoes e CMD nos comandos que nao sao blocos
+ */
+static TipoNo involucroDetalhado(TipoNo pai, TipoNo tipo) {
+    if (pai == NO_DECL_LIST) {
+        return NO_DECL;
     }
+    if (pai != NO_CMD_LIST && pai != NO_IF && pai != NO_IFELSE && pai != NO_WHILE) {
+        return NUM_TIPOS_NO;
+    }
+    switch (tipo) {
+    case NO_EXP_CMD:
+    case NO_EXP_CMD_VAZIO:
+    case NO_IF:
+    case NO_IFELSE:
+    case NO_WHILE:
+    case NO_RETURN:
+        return NO_CMD;
+    default:
+        return NUM_TIPOS_NO;
+    }
+}
+
+static void imprimirLinhaNo(Saida *saida, const TabelaAtomos *atomos, TipoNo tipo, Atomo valor,
+                            int linha, int nivel) {
+    /* Imprime indentacao (2 espacos por nivel) */
+    saidaEspacos(saida, 2 * (size_t) nivel);
     
     /* Imprime o no */
-    printf("- %s", no->tipo);
+    saidaEscrever(saida, "- ", 2);
+    saidaTexto(saida, nomeTipoNo(tipo));
     
-    /* Se tem valor, imprime entre parenteses */
-    if (no->valor[0] != '\0') {
-        printf(" (%s)", no->valor);
+    /* Se tem valor, imprime entre parenteses (o do NUM e o proprio inteiro) */
+    if (tipo == NO_NUM) {
+        saidaEscrever(saida, " (", 2);
+        saidaInteiro(saida, (int) valor);
+        saidaCaractere(saida, ')');
+    } else if (valor != ATOMO_NULO) {
+        saidaEscrever(saida, " (", 2);
+        saidaTexto(saida, nomeAtomo(atomos, valor));
+        saidaCaractere(saida, ')');
     }
     
     /* Imprime o numero da linha */
-    printf(" [linha %d]\n", no->linha);
+    saidaEscrever(saida, " [linha ", 8);
+    saidaInteiro(saida, linha);
+    saidaEscrever(saida, "]\n", 2);
+}
+
+void imprimirArvore(ContextoCompilador *ctx, Saida *saida, NoId raiz, int nivelRaiz,
+                    int detalhada) {
+    const Arvore *a = &ctx->arvore;
+    PilhaPercurso pilha = PILHA_PERCURSO_INICIAL(QuadroImpressao);
+    empilharQuadroImpressao(&pilha, raiz, nivelRaiz, NUM_TIPOS_NO);
     
-    /* Recursivamente imprime os filhos */
-    for (int i = 0; i < no->nFilhos; i++) {
-        imprimirArvore(no->filhos[i], nivel + 1);
+    /* Pre-ordem: o irmao seguinte espera na pilha enquanto os filhos saem */
+    while (pilha.total > 0) {
+        QuadroImpressao q = *(QuadroImpressao*) desempilhar(&pilha);
+        NoId no = q.no;
+        if (no == NO_NULO) {
+            continue;
+        }
+        if (no != raiz && proximoIrmao(a, no) != NO_NULO) {
+            empilharQuadroImpressao(&pilha, proximoIrmao(a, no), q.nivel, q.pai);
+        }
+        
+        /* O involucro leva a linha do no envolvido, como no parser antigo */
+        int nivel = q.nivel;
+        TipoNo involucro = detalhada ? involucroDetalhado(q.pai, tipoNo(a, no)) : NUM_TIPOS_NO;
+        if (involucro != NUM_TIPOS_NO) {
+            imprimirLinhaNo(saida, &ctx->atomos, involucro, ATOMO_NULO, linhaNo(a, no), nivel++);
+        }
+        imprimirLinhaNo(saida, &ctx->atomos, tipoNo(a, no), valorNo(a, no), linhaNo(a, no), nivel);
+        
+        if (primeiroFilho(a, no) != NO_NULO) {
+            empilharQuadroImpressao(&pilha, primeiroFilho(a, no), nivel + 1, tipoNo(a, no));
+        }
     }
+    
+    liberarPilha(&pilha);
+}
+
+void imprimirEstatisticasArvore(Saida *saida, const Arvore *a) {
+    /* As anotacoes so existem depois da analise semantica, uma por no criado */
+    size_t anotados = a->simbolos != NULL ? (a->total > 0 ? a->total : 1) : 0;
+    size_t reservados = BYTES_POR_NO_BLOCO * (size_t) a->capacidade +
+                        BYTES_POR_ANOTACAO * anotados;
+
+    saidaTexto(saida, "Memoria (arvore): ");
+    saidaInteiro(saida, a->total > 0 ? (long long) a->total - 1 : 0);
+    saidaTexto(saida, " nos, ");
+    saidaInteiro(saida, (long long) (BYTES_POR_NO_BLOCO + BYTES_POR_ANOTACAO));
+    saidaTexto(saida, " bytes por no (");
+    saidaInteiro(saida, (long long) reservados);
+    saidaTexto(saida, " bytes reservados)\n");
+}
+
+/*
+ * liberarArvore - Libera de uma vez todos os nos da compilacao
+ */
+void liberarArvore(ContextoCompilador *ctx) {
+    Arvore vazia = ARVORE_INICIAL;
+    free(ctx->arvore.bloco);
+    free(ctx->arvore.simbolos);
+    free(ctx->arvore.tiposDado);
+    ctx->arvore = vazia;
+    ctx->raiz = NO_NULO;
 }
@@ -1,21 +1,213 @@
 #ifndef ARVORE_H
 #define ARVORE_H
 
-/* Numero maximo de filhos por no */
-#define MAX_FILHOS 5
+#include "saida.h"
+#include "atomos.h"
+#include "tipos.h"
 
-typedef struct NoArvore {
-    char tipo[30];                    /* Tipo do no (ex: "IF", "WHILE", "VAR") */
-    char valor[30];                   /* Valor associado (nome, operador, etc) */
-    int linha;                        /* Linha no codigo fonte */
-    struct NoArvore *filhos[MAX_FILHOS]; /* Ponteiros para filhos */
-    int nFilhos;                      /* Numero de filhos */
-} NoArvore;
+/* Tipos de no da arvore (definidos pelas acoes do cminus.y) */
+typedef enum {
+    NO_DECL_LIST,        /* Lista de declaracoes */
+    NO_DECL,             /* Declaracao (so na impressao detalhada) */
+    NO_VAR,              /* Variavel simples */
+    NO_ARRAY_VAR,        /* Variavel array */
+    NO_TAM,              /* Tamanho do array */
+    NO_TIPO,             /* Especificador de tipo */
+    NO_FUN_DEF,          /* Definicao de funcao */
+    NO_PARAMS,           /* Parametros da funcao */
+    NO_PARAM_LIST,       /* Lista de parametros */
+    NO_PARAM,            /* Parametro simples */
+    NO_PARAM_ARRAY,      /* Parametro array */
+    NO_CORPO,            /* Corpo da funcao */
+    NO_CMD_LIST,         /* Lista de comandos */
+    NO_CMD_LIST_VAZIA,   /* Lista de comandos vazia */
+    NO_CMD,              /* Comando (so na impressao detalhada) */
+    NO_BLOCO,            /* Bloco entre chaves */
+    NO_BLOCO_VAZIO,      /* Bloco sem conteudo */
+    NO_EXP_CMD,          /* Comando de expressao */
+    NO_EXP_CMD_VAZIO,    /* Comando vazio (apenas ;) */
+    NO_IF,               /* if sem else */
+    NO_IFELSE,           /* if com else */
+    NO_WHILE,            /* Laco while */
+    NO_RETURN,           /* Retorno */
+    NO_ATRIB,            /* Atribuicao */
+    NO_REL,              /* Expressao relacional */
+    NO_OP,               /* Operador relacional */
+    NO_SOMA,             /* + */
+    NO_SUB,              /* - */
+    NO_MULT,             /* * */
+    NO_DIV,              /* / */
+    NO_NUM,              /* Literal inteiro */
+    NO_CHAMADA_FUNCAO,   /* Chamada de funcao */
+    NO_ARGS,             /* Argumentos da chamada */
+    NO_ID,               /* Uso de variavel */
+    NO_ID_ARRAY,         /* Acesso a elemento de array */
+    NUM_TIPOS_NO
+} TipoNo;
 
-NoArvore* criarNo(const char* tipo, const char* valor, int linha);
+/* Indice de um no na arvore (NO_NULO = nenhum) */
+typedef unsigned int NoId;
 
-void adicionarFilho(NoArvore* pai, NoArvore* filho);
+#define NO_NULO 0u
 
-void imprimirArvore(NoArvore* no, int nivel);
+/*
+ * Arvore em vetores paralelos (um campo por vetor), todos fatias de um
+ * unico bloco: 17 bytes por no, sem ponteiros. Os filhos formam uma lista
+ * encadeada por indices (primeiro filho e proximo irmao), na ordem do
+ * fonte. O valor e o atomo do no (nome ou operador); no NUM e o proprio
+ * inteiro, e nos nos de lista, enquanto o parser acrescenta itens, ele
+ * guarda o ultimo filho.
+ */
+typedef struct {
+    void *bloco;                  /* Memoria de todos os vetores */
+    NoId *primeiroFilho;
+    NoId *proximoIrmao;
+    Atomo *valores;
+    unsigned int *linhas;
+    unsigned char *tipos;         /* TipoNo de cada no */
+    unsigned int total;           /* Nos criados, contando o NO_NULO */
+    unsigned int capacidade;
+
+    /* Anotacoes da analise semantica (NULL antes dela): o simbolo de cada
+       ID, ID_ARRAY e CHAMADA_FUNCAO, resolvido uma vez, e o TipoDado de
+       cada expressao, calculado uma vez */
+    struct Simbolo **simbolos;
+    unsigned char *tiposDado;
+} Arvore;
+
+/* Arvore vazia; o primeiro no criado reserva o indice 0 */
+#define ARVORE_INICIAL { NULL, NULL, NULL, NULL, NULL, NULL, 0, 0, NULL, NULL }
+
+static inline TipoNo tipoNo(const Arvore *a, NoId no) {
+    return (TipoNo) a->tipos[no];
+}
+
+static inline Atomo valorNo(const Arvore *a, NoId no) {
+    return a->valores[no];
+}
+
+static inline int linhaNo(const Arvore *a, NoId no) {
+    return (int) a->linhas[no];
+}
+
+static inline NoId primeiroFilho(const Arvore *a, NoId no) {
+    return a->primeiroFilho[no];
+}
+
+static inline NoId proximoIrmao(const Arvore *a, NoId no) {
+    return a->proximoIrmao[no];
+}
+
+static inline struct Simbolo* simboloNo(const Arvore *a, NoId no) {
+    return a->simbolos != NULL ? a->simbolos[no] : NULL;
+}
+
+/* Valor de um NO_NUM, guardado no proprio campo do atomo */
+static inline int valorLiteral(const Arvore *a, NoId no) {
+    return (int) a->valores[no];
+}
+
+static inline TipoDado tipoDadoNo(const Arvore *a, NoId no) {
+    return a->tiposDado != NULL ? (TipoDado) a->tiposDado[no] : TIPO_NENHUM;
+}
+
+/* i-esimo filho (NO_NULO se nao houver) */
+static inline NoId filhoNo(const Arvore *a, NoId no, int i) {
+    NoId f = a->primeiroFilho[no];
+    while (f != NO_NULO && i-- > 0) {
+        f = a->proximoIrmao[f];
+    }
+    return f;
+}
+
+/* Quantidade de filhos */
+static inline int numFilhos(const Arvore *a, NoId no) {
+    int n = 0;
+    for (NoId f = a->primeiroFilho[no]; f != NO_NULO; f = a->proximoIrmao[f]) {
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Pilha explicita (no heap) para percorrer a arvore sem recursao: a
+ * profundidade deixa de depender da pilha de C. Cada percurso define o seu
+ * tipo de quadro; 'empilhar' pode mover os quadros, entao guarde indices.
+ */
+typedef struct {
+    char *quadros;
+    size_t tamQuadro;
+    size_t total;
+    size_t capacidade;
+} PilhaPercurso;
+
+#define PILHA_PERCURSO_INICIAL(tipoQuadro) { NULL, sizeof(tipoQuadro), 0, 0 }
+
+/* Reserva um quadro no topo (zerado) e devolve o seu endereco */
+void* empilhar(PilhaPercurso *p);
+
+/* Tira o quadro do topo; o endereco vale ate o proximo empilhar */
+void* desempilhar(PilhaPercurso *p);
+
+/* Quadro de indice i (0 = base) */
+void* quadroPilha(PilhaPercurso *p, size_t i);
+
+void liberarPilha(PilhaPercurso *p);
+
+/* Os nos vivem na arvore do contexto da compilacao */
+struct ContextoCompilador;
+
+NoId criarNo(struct ContextoCompilador *ctx, TipoNo tipo, Atomo valor, int linha);
+
+/*
+ * criarNoComFilhos - Cria um no com os 'nFilhos' filhos seguintes, do tipo
+ * NoId (os NO_NULO sao ignorados)
+ */
+NoId criarNoComFilhos(struct ContextoCompilador *ctx, TipoNo tipo, Atomo valor, int linha,
+                      int nFilhos, ...);
+
+/* Literal inteiro (NO_NUM) com o valor dado */
+NoId criarNum(struct ContextoCompilador *ctx, int valor, int linha);
+
+/*
+ * criarOperacao - No de SOMA, SUB, MULT ou DIV. Se os dois operandos forem
+ * literais a conta e feita aqui e volta um NUM (reaproveitando o no de
+ * 'esq'); divisao por zero nao e dobrada, fica para a analise semantica.
+ */
+NoId criarOperacao(struct ContextoCompilador *ctx, TipoNo tipo, Atomo operador, int linha,
+                   NoId esq, NoId dir);
+
+/* No REL; com dois literais vira o NUM 0 ou 1, como criarOperacao */
+NoId criarRelacional(struct ContextoCompilador *ctx, int linha, NoId esq, NoId op, NoId dir);
+
+
+const char* nomeTipoNo(TipoNo tipo);
+
+/* Acrescenta um item no fim de um no de lista */
+void adicionarFilho(struct ContextoCompilador *ctx, NoId pai, NoId filho);
+
+/* Cria (zerados) os vetores de anotacoes, com uma posicao por no */
+void reservarAnotacoes(Arvore *a);
+
+/* Lista completa: o valor deixa de guardar o ultimo filho */
+void fecharLista(struct ContextoCompilador *ctx, NoId lista);
+
+/*
+ * coletarDeclaracoes - Devolve (em vetor alocado com malloc) as declaracoes
+ * do topo do programa na ordem do fonte
+ */
+NoId* coletarDeclaracoes(const Arvore *a, NoId raiz, int *total);
+
+/*
+ * imprimirArvore - Imprime a subarvore em pre-ordem. Com 'detalhada', refaz
+ * os nos DECL e CMD que o parser nao cria, no formato antigo.
+ */
+void imprimirArvore(struct ContextoCompilador *ctx, Saida *saida, NoId raiz, int nivel,
+                    int detalhada);
+
+/* Nos criados e memoria ocupada pela arvore (--emit=stats) */
+void imprimirEstatisticasArvore(Saida *saida, const Arvore *a);
+
+void liberarArvore(struct ContextoCompilador *ctx);
 
 #endif
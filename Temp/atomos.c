@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atomos.h"
+
+/* Capacidade inicial da tabela de espalhamento (potencia de 2) */
+#define CAPACIDADE_INICIAL 1024
+
+/* Textos predefinidos, na mesma ordem do enum de atomos */
+static const char* const textosPredefinidos[NUM_ATOMOS_PREDEFINIDOS] = {
+    "", "int", "void", "global", "main", "input", "output",
+    "+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!="
+};
+
+/*
+ * hashTexto - FNV-1a sobre os n bytes do texto
+ */
+static unsigned int hashTexto(const char *s, size_t n) {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= (unsigned char) s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void* realocar(void *p, size_t tamanho) {
+    void *novo = realloc(p, tamanho);
+    if (novo == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a tabela de atomos\n");
+        exit(1);
+    }
+    return novo;
+}
+
+/*
+ * redimensionarPosicoes - Dobra a tabela de espalhamento e reinsere os atomos
+ */
+static void redimensionarPosicoes(TabelaAtomos *t) {
+    t->capacidadePosicoes = t->capacidadePosicoes ? t->capacidadePosicoes * 2 : CAPACIDADE_INICIAL;
+    free(t->posicoes);
+    t->posicoes = (Atomo*) calloc(t->capacidadePosicoes, sizeof(Atomo));
+    if (t->posicoes == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a tabela de atomos\n");
+        exit(1);
+    }
+
+    unsigned int mascara = t->capacidadePosicoes - 1;
+    for (Atomo a = 1; a < t->numAtomos; a++) {
+        unsigned int i = t->hashes[a] & mascara;
+        while (t->posicoes[i] != ATOMO_NULO) {
+            i = (i + 1) & mascara;
+        }
+        t->posicoes[i] = a;
+    }
+}
+
+/*
+ * novoAtomo - Registra um texto ainda nao internado
+ */
+static Atomo novoAtomo(TabelaAtomos *t, const char *s, size_t n, unsigned int h) {
+    if (t->numAtomos >= t->capacidadeAtomos) {
+        t->capacidadeAtomos = t->capacidadeAtomos ? t->capacidadeAtomos * 2 : CAPACIDADE_INICIAL;
+        t->textos = (const char**) realocar(t->textos, sizeof(*t->textos) * t->capacidadeAtomos);
+        t->tamanhos = (size_t*) realocar(t->tamanhos, sizeof(*t->tamanhos) * t->capacidadeAtomos);
+        t->hashes = (unsigned int*) realocar(t->hashes, sizeof(*t->hashes) * t->capacidadeAtomos);
+    }
+
+    Atomo a = t->numAtomos++;
+    t->textos[a] = arenaStrndup(&t->arena, s, n);
+    t->tamanhos[a] = n;
+    t->hashes[a] = h;
+    return a;
+}
+
+static Atomo buscarOuInserir(TabelaAtomos *t, const char *s, size_t n) {
+    unsigned int h = hashTexto(s, n);
+    unsigned int mascara = t->capacidadePosicoes - 1;
+    unsigned int i = h & mascara;
+
+    while (t->posicoes[i] != ATOMO_NULO) {
+        Atomo a = t->posicoes[i];
+        if (t->hashes[a] == h && t->tamanhos[a] == n && memcmp(t->textos[a], s, n) == 0) {
+            return a;  /* Ja internado */
+        }
+        i = (i + 1) & mascara;
+    }
+
+    Atomo a = novoAtomo(t, s, n, h);
+    t->posicoes[i] = a;
+
+    /* Mantem a ocupacao abaixo de 50% */
+    if (t->numAtomos * 2 > t->capacidadePosicoes) {
+        redimensionarPosicoes(t);
+    }
+    return a;
+}
+
+/*
+ * inicializarAtomos - Registra os atomos predefinidos nos seus indices fixos
+ */
+static void inicializarAtomos(TabelaAtomos *t) {
+    redimensionarPosicoes(t);
+    novoAtomo(t, "", 0, 0);  /* ATOMO_NULO nunca entra na tabela de espalhamento */
+    for (int i = 1; i < NUM_ATOMOS_PREDEFINIDOS; i++) {
+        buscarOuInserir(t, textosPredefinidos[i], strlen(textosPredefinidos[i]));
+    }
+}
+
+Atomo internarN(TabelaAtomos *t, const char *s, size_t n) {
+    if (t->posicoes == NULL) {
+        inicializarAtomos(t);
+    }
+    if (n == 0) {
+        return ATOMO_NULO;
+    }
+    return buscarOuInserir(t, s, n);
+}
+
+Atomo internar(TabelaAtomos *t, const char *s) {
+    return internarN(t, s, strlen(s));
+}
+
+const char* nomeAtomo(const TabelaAtomos *t, Atomo a) {
+    /* Os predefinidos tem texto fixo, mesmo antes da tabela existir */
+    if (a < NUM_ATOMOS_PREDEFINIDOS) {
+        return textosPredefinidos[a];
+    }
+    if (a >= t->numAtomos) {
+        return "";
+    }
+    return t->textos[a];
+}
+
+unsigned int totalAtomos(const TabelaAtomos *t) {
+    return t->numAtomos;
+}
+
+void liberarAtomos(TabelaAtomos *t) {
+    free(t->posicoes);
+    free(t->textos);
+    free(t->tamanhos);
+    free(t->hashes);
+    t->posicoes = NULL;
+    t->textos = NULL;
+    t->tamanhos = NULL;
+    t->hashes = NULL;
+    t->numAtomos = 0;
+    t->capacidadeAtomos = 0;
+    t->capacidadePosicoes = 0;
+    arenaLiberar(&t->arena);
+}
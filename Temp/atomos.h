@@ -0,0 +1,61 @@
+#ifndef ATOMOS_H
+#define ATOMOS_H
+
+#include <stddef.h>
+#include "arena.h"
+
+/*
+ * Tabela de internacao: cada nome distinto e guardado uma unica vez e
+ * identificado por um Atomo (indice inteiro). Comparar nomes vira comparar
+ * inteiros. Cada compilacao tem a sua tabela; os atomos predefinidos tem o
+ * mesmo indice em todas.
+ */
+typedef unsigned int Atomo;
+
+/* Atomos predefinidos (registrados na inicializacao, nesta ordem) */
+enum {
+    ATOMO_NULO = 0,      /* Ausencia de valor (string vazia) */
+    ATOMO_INT,           /* "int" */
+    ATOMO_VOID,          /* "void" */
+    ATOMO_GLOBAL,        /* "global" */
+    ATOMO_MAIN,          /* "main" */
+    ATOMO_INPUT,         /* "input" */
+    ATOMO_OUTPUT,        /* "output" */
+    ATOMO_MAIS,          /* "+" */
+    ATOMO_MENOS,         /* "-" */
+    ATOMO_VEZES,         /* "*" */
+    ATOMO_DIVIDIDO,      /* "/" */
+    ATOMO_MENOR,         /* "<" */
+    ATOMO_MAIOR,         /* ">" */
+    ATOMO_MENORIGUAL,    /* "<=" */
+    ATOMO_MAIORIGUAL,    /* ">=" */
+    ATOMO_IGUAL,         /* "==" */
+    ATOMO_DIFERENTE,     /* "!=" */
+    NUM_ATOMOS_PREDEFINIDOS
+};
+
+typedef struct {
+    Arena arena;                  /* Os textos vivem aqui ate liberarAtomos */
+    const char **textos;          /* Texto de cada atomo (indexado pelo Atomo) */
+    size_t *tamanhos;             /* Tamanho de cada texto */
+    unsigned int *hashes;         /* Hash de cada texto */
+    unsigned int numAtomos;
+    unsigned int capacidadeAtomos;
+    Atomo *posicoes;              /* Enderecamento aberto (ATOMO_NULO = livre) */
+    unsigned int capacidadePosicoes;
+} TabelaAtomos;
+
+/* Tabela vazia; os predefinidos sao registrados no primeiro internar */
+#define TABELA_ATOMOS_INICIAL { ARENA_INICIAL, NULL, NULL, NULL, 0, 0, NULL, 0 }
+
+Atomo internar(TabelaAtomos *t, const char *s);
+
+Atomo internarN(TabelaAtomos *t, const char *s, size_t n);
+
+const char* nomeAtomo(const TabelaAtomos *t, Atomo a);
+
+unsigned int totalAtomos(const TabelaAtomos *t);
+
+void liberarAtomos(TabelaAtomos *t);
+
+#endif
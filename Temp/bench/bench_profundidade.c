@@ -0,0 +1,161 @@
+/*
+ * bench_profundidade.c - Mede parser, analise semantica e geracao de codigo
+ * em programas com aninhamento muito profundo
+ *
+ * Gera tres formatos com profundidade 1k, 100k e 1M: expressao com
+ * parenteses aninhados, cadeia de else-if e blocos aninhados. Mostra o
+ * tempo por no da arvore em cada fase; nenhuma delas pode estourar a pilha.
+ *
+ * Compilacao (a partir de Temp/):
+ *   gcc -O2 -o bench_profundidade bench/bench_profundidade.c arvore.c semantico.c \
+ *       intermediario.c fluxo.c ssa.c simbolos.c atomos.c arena.c saida.c contexto.c \
+ *       paralelo.c lex.yy.c cminus.tab.c -lpthread
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../contexto.h"
+#include "../semantico.h"
+#include "../cminus.tab.h"
+
+typedef enum {
+    PARENTESES,   /* x = ((...(x + 1) + 1)...) + 1; (com x o parser nao dobra) */
+    ELSE_IF,      /* if (x) x = 1; else if (x) x = 1; else ... */
+    BLOCOS        /* { { { ... x = 1; ... } } } */
+} Formato;
+
+static const char* const nomesFormato[] = { "parenteses", "else-if", "blocos" };
+
+/* Texto acumulado com espaco para os dois '\0' que o scanner exige */
+typedef struct {
+    char *texto;
+    size_t tamanho;
+    size_t capacidade;
+} Texto;
+
+static void acrescentar(Texto *t, const char *s) {
+    size_t n = strlen(s);
+    if (t->tamanho + n + 2 > t->capacidade) {
+        t->capacidade = (t->tamanho + n + 2) * 2;
+        t->texto = (char*) realloc(t->texto, t->capacidade);
+        if (t->texto == NULL) {
+            fprintf(stderr, "Sem memoria para o programa gerado\n");
+            exit(1);
+        }
+    }
+    memcpy(t->texto + t->tamanho, s, n);
+    t->tamanho += n;
+}
+
+static Texto gerarPrograma(Formato formato, int profundidade) {
+    Texto t = { NULL, 0, 0 };
+    acrescentar(&t, "void main(void) {\nint x;\n");
+
+    switch (formato) {
+    case PARENTESES:
+        acrescentar(&t, "x = ");
+        for (int i = 0; i < profundidade; i++) acrescentar(&t, "(");
+        acrescentar(&t, "x");
+        for (int i = 0; i < profundidade; i++) acrescentar(&t, " + 1)");
+        acrescentar(&t, ";\n");
+        break;
+    case ELSE_IF:
+        for (int i = 0; i < profundidade; i++) acrescentar(&t, "if (x) x = 1; else\n");
+        acrescentar(&t, "x = 0;\n");
+        break;
+    case BLOCOS:
+        for (int i = 0; i < profundidade; i++) acrescentar(&t, "{ ");
+        acrescentar(&t, "x = 1;");
+        for (int i = 0; i < profundidade; i++) acrescentar(&t, " }");
+        acrescentar(&t, "\n");
+        break;
+    }
+
+    acrescentar(&t, "}\n");
+    t.texto[t.tamanho] = '\0';
+    t.texto[t.tamanho + 1] = '\0';
+    return t;
+}
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Conta os nos com a mesma pilha explicita usada pelas fases */
+static size_t contarNos(const Arvore *a, NoId raiz) {
+    PilhaPercurso pilha = PILHA_PERCURSO_INICIAL(NoId);
+    size_t total = 0;
+
+    *(NoId*) empilhar(&pilha) = raiz;
+    while (pilha.total > 0) {
+        NoId no = *(NoId*) desempilhar(&pilha);
+        total++;
+        for (NoId f = primeiroFilho(a, no); f != NO_NULO; f = proximoIrmao(a, f)) {
+            *(NoId*) empilhar(&pilha) = f;
+        }
+    }
+    liberarPilha(&pilha);
+    return total;
+}
+
+static void medir(Formato formato, int profundidade, FILE *descarte) {
+    Texto programa = gerarPrograma(formato, profundidade);
+
+    ContextoCompilador ctx;
+    iniciarContexto(&ctx);
+    ctx.mensagens = descarte;
+    ctx.erros = descarte;
+    iniciarScannerEmMemoria(&ctx, programa.texto, programa.tamanho);
+
+    double t0 = agora();
+    int resultado = yyparse(ctx.scanner, &ctx);
+    double t1 = agora();
+    if (resultado != 0 || ctx.raiz == NO_NULO) {
+        printf("%-12s %-10d falhou no parser\n", nomesFormato[formato], profundidade);
+        finalizarScanner(&ctx);
+        liberarContexto(&ctx);
+        free(programa.texto);
+        return;
+    }
+
+    int erros = analisarSemantica(&ctx);
+    double t2 = agora();
+    int instrucoes = gerarCodigoIntermediario(&ctx);
+    double t3 = agora();
+
+    size_t nos = contarNos(&ctx.arvore, ctx.raiz);
+    printf("%-12s %-10d %-10zu %-12.1f %-12.1f %-12.1f %d/%d\n",
+           nomesFormato[formato], profundidade, nos,
+           (t1 - t0) * 1e9 / nos,
+           (t2 - t1) * 1e9 / nos,
+           (t3 - t2) * 1e9 / nos,
+           instrucoes, erros);
+
+    finalizarScanner(&ctx);
+    liberarContexto(&ctx);
+    free(programa.texto);
+}
+
+int main(void) {
+    int profundidades[] = { 1000, 100000, 1000000 };
+    FILE *descarte = fopen("/dev/null", "w");
+    if (descarte == NULL) {
+        descarte = stderr;
+    }
+
+    printf("%-12s %-10s %-10s %-12s %-12s %-12s %s\n",
+           "Formato", "Profund.", "Nos", "ns/no parse", "ns/no sema", "ns/no ir", "Instr/erros");
+    for (int f = PARENTESES; f <= BLOCOS; f++) {
+        for (int i = 0; i < 3; i++) {
+            medir((Formato) f, profundidades[i], descarte);
+        }
+    }
+
+    if (descarte != stderr) {
+        fclose(descarte);
+    }
+    return 0;
+}
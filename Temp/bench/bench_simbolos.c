@@ -0,0 +1,92 @@
+/*
+ * bench_simbolos.c - Mede insercao e busca na tabela de simbolos
+ *
+ * Constroi tabelas com 1k, 100k e 1M simbolos (metade global, metade
+ * espalhada em escopos de funcao) e consulta cada um deles, inclusive
+ * buscas que caem no escopo global e buscas sem sucesso.
+ *
+ * Compilacao (a partir de Temp/):
+ *   gcc -O2 -o bench_simbolos bench/bench_simbolos.c simbolos.c atomos.c arena.c saida.c -lpthread
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../simbolos.h"
+#include "../atomos.h"
+
+/* Quantidade de funcoes entre as quais os locais sao distribuidos */
+#define NUM_ESCOPOS 64
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void medir(TabelaAtomos *atomos, unsigned int n) {
+    TabelaSimbolos ts = TABELA_SIMBOLOS_INICIAL;
+    Atomo *nomes = (Atomo*) malloc(sizeof(Atomo) * n);
+    Escopo *escopos[NUM_ESCOPOS];
+    char texto[32];
+
+    for (unsigned int i = 0; i < n; i++) {
+        sprintf(texto, "v%u", i);
+        nomes[i] = internar(atomos, texto);
+    }
+    for (int e = 0; e < NUM_ESCOPOS; e++) {
+        sprintf(texto, "f%d", e);
+        escopos[e] = entrarEscopo(&ts, escopoGlobal(&ts), internar(atomos, texto));
+    }
+
+    /* Construcao: metade global, metade local */
+    double t0 = agora();
+    for (unsigned int i = 0; i < n; i++) {
+        Escopo *escopo = (i % 2 == 0) ? escopoGlobal(&ts) : escopos[i % NUM_ESCOPOS];
+        inserirSimbolo(&ts, nomes[i], TIPO_INT, escopo, (int) i, 0, 0);
+    }
+    double t1 = agora();
+
+    /* Consulta: cada nome a partir de um escopo de funcao (locais e globais) */
+    unsigned int encontrados = 0;
+    for (unsigned int i = 0; i < n; i++) {
+        if (buscarSimbolo(&ts, nomes[i], escopos[i % NUM_ESCOPOS]) != NULL) {
+            encontrados++;
+        }
+    }
+    double t2 = agora();
+
+    /* Consulta sem sucesso: locais procurados no escopo errado */
+    unsigned int ausentes = 0;
+    for (unsigned int i = 1; i < n; i += 2) {
+        if (buscarSimbolo(&ts, nomes[i], escopos[(i + 1) % NUM_ESCOPOS]) == NULL) {
+            ausentes++;
+        }
+    }
+    double t3 = agora();
+
+    /* Os dois totais conferem: todos os simbolos achados, todas as n/2
+       buscas sem sucesso */
+    sprintf(texto, "%u/%u", encontrados, numeroDeSimbolos(&ts));
+    printf("%-10u %-14.1f %-14.1f %-14.1f %-16s %u/%u\n",
+           n,
+           (t1 - t0) * 1e9 / n,
+           (t2 - t1) * 1e9 / n,
+           (t3 - t2) * 1e9 / (n / 2 ? n / 2 : 1),
+           texto, ausentes, n / 2);
+    liberarTabelaSimbolos(&ts);
+    free(nomes);
+}
+
+int main(void) {
+    unsigned int tamanhos[] = { 1000, 100000, 1000000 };
+    TabelaAtomos atomos = TABELA_ATOMOS_INICIAL;
+
+    printf("%-10s %-14s %-14s %-14s %-16s %s\n",
+           "Simbolos", "ns/insercao", "ns/busca", "ns/ausente", "Encontrados", "Ausentes");
+    for (int i = 0; i < 3; i++) {
+        medir(&atomos, tamanhos[i]);
+    }
+
+    liberarAtomos(&atomos);
+    return 0;
+}
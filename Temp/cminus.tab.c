@@ -55,7 +55,7 @@
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -73,38 +73,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include "arvore.h"
-#include "simbolos.h"
-#include "semantico.h"
-#include "intermediario.h"
-
-/* Funcoes externas do scanner */
-extern int yylex();
-extern int linha;
-
-/* Funcoes externas da tabela de tokens (do scanner) */
-extern void imprimirTabelaTokens(void);
-extern void resetarTabelaTokens(void);
-extern void imprimirErrosLexicos(void);
-extern void resetarErrosLexicos(void);
-
-/* Raiz da arvore sintatica - sera preenchida durante o parsing */
-NoArvore* raiz = NULL;
 
 /* Flag de debug do Bison */
 int yydebug;
 
-/* Variavel externa do Flex com o token atual */
-extern char *yytext;
-
-void yyerror(char *s) {
-    if (yytext && yytext[0] != '\0') {
-        fprintf(stderr, "ERRO SINTATICO: '%s' (esperado: %s) LINHA: %d\n", yytext, s, linha);
-    } else {
-        fprintf(stderr, "ERRO SINTATICO: %s LINHA: %d\n", s, linha);
-    }
-}
+/* A pilha do parser cresce no heap conforme a necessidade; o limite padrao
+   (10000) abortava expressoes e cadeias de else-if muito aninhadas */
+#define YYMAXDEPTH 50000000
 
-#line 108 "cminus.tab.c"
+#line 85 "cminus.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -193,6 +170,20 @@ typedef enum yysymbol_kind_t yysymbol_kind_t;
 
 
 
+/* Unqualified %code blocks.  */
+#line 28 "cminus.y"
+
+void yyerror(void *scanner, ContextoCompilador *ctx, const char *s) {
+    /* Token atual do scanner desta compilacao */
+    const char *texto = yyget_text(scanner);
+    if (texto && texto[0] != '\0') {
+        fprintf(ctx->erros, "ERRO SINTATICO: '%s' (esperado: %s) LINHA: %d\n", texto, s, ctx->lexico.linha);
+    } else {
+        fprintf(ctx->erros, "ERRO SINTATICO: %s LINHA: %d\n", s, ctx->lexico.linha);
+    }
+}
+
+#line 187 "cminus.tab.c"
 
 #ifdef short
 # undef short
@@ -576,13 +567,13 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    67,    67,    72,    77,    82,    86,    94,    98,   109,
-     110,   115,   125,   126,   134,   139,   144,   148,   156,   161,
-     169,   174,   175,   182,   186,   190,   194,   198,   205,   210,
-     214,   218,   225,   229,   236,   242,   251,   260,   263,   271,
-     276,   281,   287,   292,   293,   294,   295,   296,   297,   302,
-     307,   312,   317,   322,   327,   332,   333,   334,   339,   342,
-     350,   354,   362,   365
+       0,    74,    74,    80,    84,    93,    94,    99,   102,   112,
+     113,   118,   128,   129,   137,   141,   149,   152,   159,   164,
+     172,   176,   180,   188,   189,   190,   191,   192,   197,   202,
+     206,   210,   217,   220,   227,   233,   242,   251,   254,   261,
+     264,   269,   272,   277,   278,   279,   280,   281,   282,   287,
+     290,   293,   298,   301,   304,   309,   310,   311,   312,   315,
+     323,   327,   335,   338
 };
 #endif
 
@@ -792,7 +783,7 @@ enum { YYENOMEM = -2 };
       }                                                           \
     else                                                          \
       {                                                           \
-        yyerror (YY_("syntax error: cannot back up")); \
+        yyerror (scanner, ctx, YY_("syntax error: cannot back up")); \
         YYERROR;                                                  \
       }                                                           \
   while (0)
@@ -825,7 +816,7 @@ do {                                                                      \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Kind, Value); \
+                  Kind, Value, scanner, ctx); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -837,10 +828,12 @@ do {                                                                      \
 
 static void
 yy_symbol_value_print (FILE *yyo,
-                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner, ContextoCompilador *ctx)
 {
   FILE *yyoutput = yyo;
   YY_USE (yyoutput);
+  YY_USE (scanner);
+  YY_USE (ctx);
   if (!yyvaluep)
     return;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
@@ -855,12 +848,12 @@ yy_symbol_value_print (FILE *yyo,
 
 static void
 yy_symbol_print (FILE *yyo,
-                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void *scanner, ContextoCompilador *ctx)
 {
   YYFPRINTF (yyo, "%s %s (",
              yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner, ctx);
   YYFPRINTF (yyo, ")");
 }
 
@@ -894,7 +887,7 @@ do {                                                            \
 
 static void
 yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
-                 int yyrule)
+                 int yyrule, void *scanner, ContextoCompilador *ctx)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -907,7 +900,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
                        YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
-                       &yyvsp[(yyi + 1) - (yynrhs)]);
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner, ctx);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -915,7 +908,7 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner, ctx); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
@@ -956,9 +949,11 @@ int yydebug;
 
 static void
 yydestruct (const char *yymsg,
-            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void *scanner, ContextoCompilador *ctx)
 {
   YY_USE (yyvaluep);
+  YY_USE (scanner);
+  YY_USE (ctx);
   if (!yymsg)
     yymsg = "Deleting";
   YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
@@ -969,13 +964,6 @@ yydestruct (const char *yymsg,
 }
 
 
-/* Lookahead token kind.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 
@@ -985,8 +973,21 @@ int yynerrs;
 `----------*/
 
 int
-yyparse (void)
+yyparse (void *scanner, ContextoCompilador *ctx)
 {
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
     yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
     int yyerrstatus = 0;
@@ -1139,7 +1140,7 @@ yybackup:
   if (yychar == YYEMPTY)
     {
       YYDPRINTF ((stderr, "Reading a token\n"));
-      yychar = yylex ();
+      yychar = yylex (&yylval, scanner);
     }
 
   if (yychar <= YYEOF)
@@ -1227,523 +1228,485 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* programa: declaracao_lista  */
-#line 67 "cminus.y"
-                       { raiz = (yyvsp[0].no); }
-#line 1233 "cminus.tab.c"
+#line 74 "cminus.y"
+                       { fecharLista(ctx, (yyvsp[0].no)); ctx->raiz = (yyvsp[0].no); }
+#line 1234 "cminus.tab.c"
     break;
 
   case 3: /* declaracao_lista: declaracao_lista declaracao  */
-#line 72 "cminus.y"
+#line 80 "cminus.y"
                                 {
-        (yyval.no) = criarNo("DECL_LIST", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        adicionarFilho(ctx, (yyvsp[-1].no), (yyvsp[0].no));
+        (yyval.no) = (yyvsp[-1].no);
     }
 #line 1243 "cminus.tab.c"
     break;
 
   case 4: /* declaracao_lista: declaracao  */
-#line 77 "cminus.y"
-               { (yyval.no) = (yyvsp[0].no); }
-#line 1249 "cminus.tab.c"
+#line 84 "cminus.y"
+               {
+        (yyval.no) = criarNo(ctx, NO_DECL_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, (yyval.no), (yyvsp[0].no));
+    }
+#line 1252 "cminus.tab.c"
     break;
 
   case 5: /* declaracao: var_declaracao  */
-#line 82 "cminus.y"
-                   {
-        (yyval.no) = criarNo("DECL", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
+#line 93 "cminus.y"
+                   { (yyval.no) = (yyvsp[0].no); }
 #line 1258 "cminus.tab.c"
     break;
 
   case 6: /* declaracao: fun_declaracao  */
-#line 86 "cminus.y"
-                   {
-        (yyval.no) = criarNo("DECL", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
-#line 1267 "cminus.tab.c"
+#line 94 "cminus.y"
+                   { (yyval.no) = (yyvsp[0].no); }
+#line 1264 "cminus.tab.c"
     break;
 
   case 7: /* var_declaracao: tipo_especificador ID PONTOVIRGULA  */
-#line 94 "cminus.y"
+#line 99 "cminus.y"
                                        {
-        (yyval.no) = criarNo("VAR", (yyvsp[-1].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_VAR, (yyvsp[-1].atomo), ctx->lexico.linha, 1, (yyvsp[-2].no));
     }
-#line 1276 "cminus.tab.c"
+#line 1272 "cminus.tab.c"
     break;
 
   case 8: /* var_declaracao: tipo_especificador ID ABRECOLCHETE NUM FECHACOLCHETE PONTOVIRGULA  */
-#line 98 "cminus.y"
+#line 102 "cminus.y"
                                                                       {
         char numstr[16]; 
         sprintf(numstr, "%d", (yyvsp[-2].num));
-        (yyval.no) = criarNo("ARRAY_VAR", (yyvsp[-4].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-5].no));
-        adicionarFilho((yyval.no), criarNo("TAM", numstr, linha));
+        NoId tam = criarNo(ctx, NO_TAM, internar(&ctx->atomos, numstr), ctx->lexico.linha);
+        (yyval.no) = criarNoComFilhos(ctx, NO_ARRAY_VAR, (yyvsp[-4].atomo), ctx->lexico.linha, 2, (yyvsp[-5].no), tam);
     }
-#line 1288 "cminus.tab.c"
+#line 1283 "cminus.tab.c"
     break;
 
   case 9: /* tipo_especificador: INT  */
-#line 109 "cminus.y"
-         { (yyval.no) = criarNo("TIPO", "int", linha); }
-#line 1294 "cminus.tab.c"
+#line 112 "cminus.y"
+         { (yyval.no) = criarNo(ctx, NO_TIPO, ATOMO_INT, ctx->lexico.linha); }
+#line 1289 "cminus.tab.c"
     break;
 
   case 10: /* tipo_especificador: VOID  */
-#line 110 "cminus.y"
-         { (yyval.no) = criarNo("TIPO", "void", linha); }
-#line 1300 "cminus.tab.c"
+#line 113 "cminus.y"
+         { (yyval.no) = criarNo(ctx, NO_TIPO, ATOMO_VOID, ctx->lexico.linha); }
+#line 1295 "cminus.tab.c"
     break;
 
   case 11: /* fun_declaracao: tipo_especificador ID ABREPARENTESES parametros FECHAPARENTESES corpo_funcao  */
-#line 115 "cminus.y"
+#line 118 "cminus.y"
                                                                                  {
-        (yyval.no) = criarNo("FUN_DEF", (yyvsp[-4].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-5].no));   /* tipo de retorno */
-        adicionarFilho((yyval.no), (yyvsp[-2].no));   /* parametros */
-        adicionarFilho((yyval.no), (yyvsp[0].no));   /* corpo */
+        (yyval.no) = criarNoComFilhos(ctx, NO_FUN_DEF, (yyvsp[-4].atomo), ctx->lexico.linha, 3,
+                              (yyvsp[-5].no),  /* tipo de retorno */
+                              (yyvsp[-2].no),  /* parametros */
+                              (yyvsp[0].no));  /* corpo */
     }
-#line 1311 "cminus.tab.c"
+#line 1306 "cminus.tab.c"
     break;
 
   case 12: /* parametros: VOID  */
-#line 125 "cminus.y"
-         { (yyval.no) = criarNo("PARAMS", "void", linha); }
-#line 1317 "cminus.tab.c"
+#line 128 "cminus.y"
+         { (yyval.no) = criarNo(ctx, NO_PARAMS, ATOMO_VOID, ctx->lexico.linha); }
+#line 1312 "cminus.tab.c"
     break;
 
   case 13: /* parametros: parametro_lista  */
-#line 126 "cminus.y"
+#line 129 "cminus.y"
                     {
-        (yyval.no) = criarNo("PARAMS", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        fecharLista(ctx, (yyvsp[0].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_PARAMS, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[0].no));
     }
-#line 1326 "cminus.tab.c"
+#line 1321 "cminus.tab.c"
     break;
 
   case 14: /* parametro_lista: parametro_lista VIRGULA parametro  */
-#line 134 "cminus.y"
+#line 137 "cminus.y"
                                       {
-        (yyval.no) = criarNo("PARAM_LIST", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        adicionarFilho(ctx, (yyvsp[-2].no), (yyvsp[0].no));
+        (yyval.no) = (yyvsp[-2].no);
     }
-#line 1336 "cminus.tab.c"
+#line 1330 "cminus.tab.c"
     break;
 
   case 15: /* parametro_lista: parametro  */
-#line 139 "cminus.y"
-              { (yyval.no) = (yyvsp[0].no); }
-#line 1342 "cminus.tab.c"
+#line 141 "cminus.y"
+              {
+        (yyval.no) = criarNo(ctx, NO_PARAM_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, (yyval.no), (yyvsp[0].no));
+    }
+#line 1339 "cminus.tab.c"
     break;
 
   case 16: /* parametro: tipo_especificador ID  */
-#line 144 "cminus.y"
+#line 149 "cminus.y"
                           {
-        (yyval.no) = criarNo("PARAM", (yyvsp[0].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_PARAM, (yyvsp[0].atomo), ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1351 "cminus.tab.c"
+#line 1347 "cminus.tab.c"
     break;
 
   case 17: /* parametro: tipo_especificador ID ABRECOLCHETE FECHACOLCHETE  */
-#line 148 "cminus.y"
+#line 152 "cminus.y"
                                                      {
-        (yyval.no) = criarNo("PARAM_ARRAY", (yyvsp[-2].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-3].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_PARAM_ARRAY, (yyvsp[-2].atomo), ctx->lexico.linha, 1, (yyvsp[-3].no));
     }
-#line 1360 "cminus.tab.c"
+#line 1355 "cminus.tab.c"
     break;
 
   case 18: /* corpo_funcao: ABRECHAVE declaracao_lista comando_lista FECHACHAVE  */
-#line 156 "cminus.y"
+#line 159 "cminus.y"
                                                         {
-        (yyval.no) = criarNo("CORPO", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-2].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_CORPO, ATOMO_NULO, ctx->lexico.linha, 2, (yyvsp[-2].no), (yyvsp[-1].no));
     }
-#line 1370 "cminus.tab.c"
+#line 1365 "cminus.tab.c"
     break;
 
   case 19: /* corpo_funcao: ABRECHAVE comando_lista FECHACHAVE  */
-#line 161 "cminus.y"
+#line 164 "cminus.y"
                                        {
-        (yyval.no) = criarNo("CORPO", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_CORPO, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1379 "cminus.tab.c"
+#line 1374 "cminus.tab.c"
     break;
 
   case 20: /* comando_lista: comando_lista comando  */
-#line 169 "cminus.y"
+#line 172 "cminus.y"
                           {
-        (yyval.no) = criarNo("CMD_LIST", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        adicionarFilho(ctx, (yyvsp[-1].no), (yyvsp[0].no));
+        (yyval.no) = (yyvsp[-1].no);
     }
-#line 1389 "cminus.tab.c"
+#line 1383 "cminus.tab.c"
     break;
 
   case 21: /* comando_lista: comando  */
-#line 174 "cminus.y"
-            { (yyval.no) = (yyvsp[0].no); }
-#line 1395 "cminus.tab.c"
+#line 176 "cminus.y"
+            {
+        (yyval.no) = criarNo(ctx, NO_CMD_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, (yyval.no), (yyvsp[0].no));
+    }
+#line 1392 "cminus.tab.c"
     break;
 
   case 22: /* comando_lista: %empty  */
-#line 175 "cminus.y"
+#line 180 "cminus.y"
                 {
-        (yyval.no) = criarNo("CMD_LIST_VAZIA", NULL, linha);
+        (yyval.no) = criarNo(ctx, NO_CMD_LIST_VAZIA, ATOMO_NULO, ctx->lexico.linha);
     }
-#line 1403 "cminus.tab.c"
+#line 1400 "cminus.tab.c"
     break;
 
   case 23: /* comando: expressao_comando  */
-#line 182 "cminus.y"
-                      {
-        (yyval.no) = criarNo("CMD", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
-#line 1412 "cminus.tab.c"
+#line 188 "cminus.y"
+                      { (yyval.no) = (yyvsp[0].no); }
+#line 1406 "cminus.tab.c"
     break;
 
   case 24: /* comando: selecao_comando  */
-#line 186 "cminus.y"
-                    {
-        (yyval.no) = criarNo("CMD", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
-#line 1421 "cminus.tab.c"
+#line 189 "cminus.y"
+                      { (yyval.no) = (yyvsp[0].no); }
+#line 1412 "cminus.tab.c"
     break;
 
   case 25: /* comando: iteracao_comando  */
 #line 190 "cminus.y"
-                     {
-        (yyval.no) = criarNo("CMD", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
-#line 1430 "cminus.tab.c"
+                      { (yyval.no) = (yyvsp[0].no); }
+#line 1418 "cminus.tab.c"
     break;
 
   case 26: /* comando: retorno_comando  */
-#line 194 "cminus.y"
-                    {
-        (yyval.no) = criarNo("CMD", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
-    }
-#line 1439 "cminus.tab.c"
+#line 191 "cminus.y"
+                      { (yyval.no) = (yyvsp[0].no); }
+#line 1424 "cminus.tab.c"
     break;
 
   case 27: /* comando: bloco_comando  */
-#line 198 "cminus.y"
-                  {
-        (yyval.no) = (yyvsp[0].no);
-    }
-#line 1447 "cminus.tab.c"
+#line 192 "cminus.y"
+                      { (yyval.no) = (yyvsp[0].no); }
+#line 1430 "cminus.tab.c"
     break;
 
   case 28: /* bloco_comando: ABRECHAVE declaracao_lista comando_lista FECHACHAVE  */
-#line 205 "cminus.y"
+#line 197 "cminus.y"
                                                         {
-        (yyval.no) = criarNo("BLOCO", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-2].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 2, (yyvsp[-2].no), (yyvsp[-1].no));
     }
-#line 1457 "cminus.tab.c"
+#line 1440 "cminus.tab.c"
     break;
 
   case 29: /* bloco_comando: ABRECHAVE comando_lista FECHACHAVE  */
-#line 210 "cminus.y"
+#line 202 "cminus.y"
                                        {
-        (yyval.no) = criarNo("BLOCO", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1466 "cminus.tab.c"
+#line 1449 "cminus.tab.c"
     break;
 
   case 30: /* bloco_comando: ABRECHAVE declaracao_lista FECHACHAVE  */
-#line 214 "cminus.y"
+#line 206 "cminus.y"
                                           {
-        (yyval.no) = criarNo("BLOCO", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1475 "cminus.tab.c"
+#line 1458 "cminus.tab.c"
     break;
 
   case 31: /* bloco_comando: ABRECHAVE FECHACHAVE  */
-#line 218 "cminus.y"
+#line 210 "cminus.y"
                          {
-        (yyval.no) = criarNo("BLOCO_VAZIO", NULL, linha);
+        (yyval.no) = criarNo(ctx, NO_BLOCO_VAZIO, ATOMO_NULO, ctx->lexico.linha);
     }
-#line 1483 "cminus.tab.c"
+#line 1466 "cminus.tab.c"
     break;
 
   case 32: /* expressao_comando: expressao PONTOVIRGULA  */
-#line 225 "cminus.y"
+#line 217 "cminus.y"
                            {
-        (yyval.no) = criarNo("EXP_CMD", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_EXP_CMD, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1492 "cminus.tab.c"
+#line 1474 "cminus.tab.c"
     break;
 
   case 33: /* expressao_comando: PONTOVIRGULA  */
-#line 229 "cminus.y"
+#line 220 "cminus.y"
                  {
-        (yyval.no) = criarNo("EXP_CMD_VAZIO", NULL, linha);
+        (yyval.no) = criarNo(ctx, NO_EXP_CMD_VAZIO, ATOMO_NULO, ctx->lexico.linha);
     }
-#line 1500 "cminus.tab.c"
+#line 1482 "cminus.tab.c"
     break;
 
   case 34: /* selecao_comando: IF ABREPARENTESES expressao FECHAPARENTESES comando ELSE comando  */
-#line 236 "cminus.y"
+#line 227 "cminus.y"
                                                                      {
-        (yyval.no) = criarNo("IFELSE", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-4].no));  /* condicao */
-        adicionarFilho((yyval.no), (yyvsp[-2].no));  /* bloco then */
-        adicionarFilho((yyval.no), (yyvsp[0].no));  /* bloco else */
+        (yyval.no) = criarNoComFilhos(ctx, NO_IFELSE, ATOMO_NULO, ctx->lexico.linha, 3,
+                              (yyvsp[-4].no),  /* condicao */
+                              (yyvsp[-2].no),  /* bloco then */
+                              (yyvsp[0].no));  /* bloco else */
     }
-#line 1511 "cminus.tab.c"
+#line 1493 "cminus.tab.c"
     break;
 
   case 35: /* selecao_comando: IF ABREPARENTESES expressao FECHAPARENTESES comando  */
-#line 242 "cminus.y"
+#line 233 "cminus.y"
                                                         {
-        (yyval.no) = criarNo("IF", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));  /* condicao */
-        adicionarFilho((yyval.no), (yyvsp[0].no));  /* bloco then */
+        (yyval.no) = criarNoComFilhos(ctx, NO_IF, ATOMO_NULO, ctx->lexico.linha, 2,
+                              (yyvsp[-2].no),  /* condicao */
+                              (yyvsp[0].no));  /* bloco then */
     }
-#line 1521 "cminus.tab.c"
+#line 1503 "cminus.tab.c"
     break;
 
   case 36: /* iteracao_comando: WHILE ABREPARENTESES expressao FECHAPARENTESES comando  */
-#line 251 "cminus.y"
+#line 242 "cminus.y"
                                                            {
-        (yyval.no) = criarNo("WHILE", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));  /* condicao */
-        adicionarFilho((yyval.no), (yyvsp[0].no));  /* corpo do loop */
+        (yyval.no) = criarNoComFilhos(ctx, NO_WHILE, ATOMO_NULO, ctx->lexico.linha, 2,
+                              (yyvsp[-2].no),  /* condicao */
+                              (yyvsp[0].no));  /* corpo do loop */
     }
-#line 1531 "cminus.tab.c"
+#line 1513 "cminus.tab.c"
     break;
 
   case 37: /* retorno_comando: RETURN PONTOVIRGULA  */
-#line 260 "cminus.y"
+#line 251 "cminus.y"
                         {
-        (yyval.no) = criarNo("RETURN", NULL, linha);
+        (yyval.no) = criarNo(ctx, NO_RETURN, ATOMO_NULO, ctx->lexico.linha);
     }
-#line 1539 "cminus.tab.c"
+#line 1521 "cminus.tab.c"
     break;
 
   case 38: /* retorno_comando: RETURN expressao PONTOVIRGULA  */
-#line 263 "cminus.y"
+#line 254 "cminus.y"
                                   {
-        (yyval.no) = criarNo("RETURN", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_RETURN, ATOMO_NULO, ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1548 "cminus.tab.c"
+#line 1529 "cminus.tab.c"
     break;
 
   case 39: /* expressao: var ATRIBUICAO expressao  */
-#line 271 "cminus.y"
+#line 261 "cminus.y"
                              {
-        (yyval.no) = criarNo("ATRIB", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_ATRIB, ATOMO_NULO, ctx->lexico.linha, 2, (yyvsp[-2].no), (yyvsp[0].no));
     }
-#line 1558 "cminus.tab.c"
+#line 1537 "cminus.tab.c"
     break;
 
   case 40: /* expressao: simples_expressao  */
-#line 276 "cminus.y"
+#line 264 "cminus.y"
                       { (yyval.no) = (yyvsp[0].no); }
-#line 1564 "cminus.tab.c"
+#line 1543 "cminus.tab.c"
     break;
 
   case 41: /* simples_expressao: soma_expressao relacional soma_expressao  */
-#line 281 "cminus.y"
+#line 269 "cminus.y"
                                              {
-        (yyval.no) = criarNo("REL", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarRelacional(ctx, ctx->lexico.linha, (yyvsp[-2].no), (yyvsp[-1].no), (yyvsp[0].no));
     }
-#line 1575 "cminus.tab.c"
+#line 1551 "cminus.tab.c"
     break;
 
   case 42: /* simples_expressao: soma_expressao  */
-#line 287 "cminus.y"
+#line 272 "cminus.y"
                    { (yyval.no) = (yyvsp[0].no); }
-#line 1581 "cminus.tab.c"
+#line 1557 "cminus.tab.c"
     break;
 
   case 43: /* relacional: MENOR  */
-#line 292 "cminus.y"
-                 { (yyval.no) = criarNo("OP", "<", linha); }
-#line 1587 "cminus.tab.c"
+#line 277 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_MENOR, ctx->lexico.linha); }
+#line 1563 "cminus.tab.c"
     break;
 
   case 44: /* relacional: MAIOR  */
-#line 293 "cminus.y"
-                 { (yyval.no) = criarNo("OP", ">", linha); }
-#line 1593 "cminus.tab.c"
+#line 278 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_MAIOR, ctx->lexico.linha); }
+#line 1569 "cminus.tab.c"
     break;
 
   case 45: /* relacional: MENORIGUAL  */
-#line 294 "cminus.y"
-                 { (yyval.no) = criarNo("OP", "<=", linha); }
-#line 1599 "cminus.tab.c"
+#line 279 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_MENORIGUAL, ctx->lexico.linha); }
+#line 1575 "cminus.tab.c"
     break;
 
   case 46: /* relacional: MAIORIGUAL  */
-#line 295 "cminus.y"
-                 { (yyval.no) = criarNo("OP", ">=", linha); }
-#line 1605 "cminus.tab.c"
+#line 280 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_MAIORIGUAL, ctx->lexico.linha); }
+#line 1581 "cminus.tab.c"
     break;
 
   case 47: /* relacional: IGUAL  */
-#line 296 "cminus.y"
-                 { (yyval.no) = criarNo("OP", "==", linha); }
-#line 1611 "cminus.tab.c"
+#line 281 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_IGUAL, ctx->lexico.linha); }
+#line 1587 "cminus.tab.c"
     break;
 
   case 48: /* relacional: DIFERENTE  */
-#line 297 "cminus.y"
-                 { (yyval.no) = criarNo("OP", "!=", linha); }
-#line 1617 "cminus.tab.c"
+#line 282 "cminus.y"
+                 { (yyval.no) = criarNo(ctx, NO_OP, ATOMO_DIFERENTE, ctx->lexico.linha); }
+#line 1593 "cminus.tab.c"
     break;
 
   case 49: /* soma_expressao: soma_expressao MAIS termo  */
-#line 302 "cminus.y"
+#line 287 "cminus.y"
                               {
-        (yyval.no) = criarNo("SOMA", "+", linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarOperacao(ctx, NO_SOMA, ATOMO_MAIS, ctx->lexico.linha, (yyvsp[-2].no), (yyvsp[0].no));
     }
-#line 1627 "cminus.tab.c"
+#line 1601 "cminus.tab.c"
     break;
 
   case 50: /* soma_expressao: soma_expressao MENOS termo  */
-#line 307 "cminus.y"
+#line 290 "cminus.y"
                                {
-        (yyval.no) = criarNo("SUB", "-", linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarOperacao(ctx, NO_SUB, ATOMO_MENOS, ctx->lexico.linha, (yyvsp[-2].no), (yyvsp[0].no));
     }
-#line 1637 "cminus.tab.c"
+#line 1609 "cminus.tab.c"
     break;
 
   case 51: /* soma_expressao: termo  */
-#line 312 "cminus.y"
+#line 293 "cminus.y"
           { (yyval.no) = (yyvsp[0].no); }
-#line 1643 "cminus.tab.c"
+#line 1615 "cminus.tab.c"
     break;
 
   case 52: /* termo: termo VEZES fator  */
-#line 317 "cminus.y"
+#line 298 "cminus.y"
                       {
-        (yyval.no) = criarNo("MULT", "*", linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarOperacao(ctx, NO_MULT, ATOMO_VEZES, ctx->lexico.linha, (yyvsp[-2].no), (yyvsp[0].no));
     }
-#line 1653 "cminus.tab.c"
+#line 1623 "cminus.tab.c"
     break;
 
   case 53: /* termo: termo DIVIDIDO fator  */
-#line 322 "cminus.y"
+#line 301 "cminus.y"
                          {
-        (yyval.no) = criarNo("DIV", "/", linha);
-        adicionarFilho((yyval.no), (yyvsp[-2].no));
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarOperacao(ctx, NO_DIV, ATOMO_DIVIDIDO, ctx->lexico.linha, (yyvsp[-2].no), (yyvsp[0].no));
     }
-#line 1663 "cminus.tab.c"
+#line 1631 "cminus.tab.c"
     break;
 
   case 54: /* termo: fator  */
-#line 327 "cminus.y"
+#line 304 "cminus.y"
           { (yyval.no) = (yyvsp[0].no); }
-#line 1669 "cminus.tab.c"
+#line 1637 "cminus.tab.c"
     break;
 
   case 55: /* fator: ABREPARENTESES expressao FECHAPARENTESES  */
-#line 332 "cminus.y"
+#line 309 "cminus.y"
                                              { (yyval.no) = (yyvsp[-1].no); }
-#line 1675 "cminus.tab.c"
+#line 1643 "cminus.tab.c"
     break;
 
   case 56: /* fator: var  */
-#line 333 "cminus.y"
+#line 310 "cminus.y"
         { (yyval.no) = (yyvsp[0].no); }
-#line 1681 "cminus.tab.c"
+#line 1649 "cminus.tab.c"
     break;
 
   case 57: /* fator: NUM  */
-#line 334 "cminus.y"
-        {
-        char numstr[16];
-        sprintf(numstr, "%d", (yyvsp[0].num));
-        (yyval.no) = criarNo("NUM", numstr, linha);
-    }
-#line 1691 "cminus.tab.c"
+#line 311 "cminus.y"
+        { (yyval.no) = criarNum(ctx, (yyvsp[0].num), ctx->lexico.linha); }
+#line 1655 "cminus.tab.c"
     break;
 
   case 58: /* fator: ID ABREPARENTESES FECHAPARENTESES  */
-#line 339 "cminus.y"
+#line 312 "cminus.y"
                                       {
-        (yyval.no) = criarNo("CHAMADA_FUNCAO", (yyvsp[-2].str), linha);
+        (yyval.no) = criarNo(ctx, NO_CHAMADA_FUNCAO, (yyvsp[-2].atomo), ctx->lexico.linha);
     }
-#line 1699 "cminus.tab.c"
+#line 1663 "cminus.tab.c"
     break;
 
   case 59: /* fator: ID ABREPARENTESES args_funcao FECHAPARENTESES  */
-#line 342 "cminus.y"
+#line 315 "cminus.y"
                                                   {
-        (yyval.no) = criarNo("CHAMADA_FUNCAO", (yyvsp[-3].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        fecharLista(ctx, (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_CHAMADA_FUNCAO, (yyvsp[-3].atomo), ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1708 "cminus.tab.c"
+#line 1672 "cminus.tab.c"
     break;
 
   case 60: /* args_funcao: expressao  */
-#line 350 "cminus.y"
+#line 323 "cminus.y"
               {
-        (yyval.no) = criarNo("ARGS", NULL, linha);
-        adicionarFilho((yyval.no), (yyvsp[0].no));
+        (yyval.no) = criarNo(ctx, NO_ARGS, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, (yyval.no), (yyvsp[0].no));
     }
-#line 1717 "cminus.tab.c"
+#line 1681 "cminus.tab.c"
     break;
 
   case 61: /* args_funcao: args_funcao VIRGULA expressao  */
-#line 354 "cminus.y"
+#line 327 "cminus.y"
                                   {
-        adicionarFilho((yyvsp[-2].no), (yyvsp[0].no));
+        adicionarFilho(ctx, (yyvsp[-2].no), (yyvsp[0].no));
         (yyval.no) = (yyvsp[-2].no);
     }
-#line 1726 "cminus.tab.c"
+#line 1690 "cminus.tab.c"
     break;
 
   case 62: /* var: ID  */
-#line 362 "cminus.y"
+#line 335 "cminus.y"
          {
-        (yyval.no) = criarNo("ID", (yyvsp[0].str), linha);
+        (yyval.no) = criarNo(ctx, NO_ID, (yyvsp[0].atomo), ctx->lexico.linha);
     }
-#line 1734 "cminus.tab.c"
+#line 1698 "cminus.tab.c"
     break;
 
   case 63: /* var: ID ABRECOLCHETE expressao FECHACOLCHETE  */
-#line 365 "cminus.y"
+#line 338 "cminus.y"
                                               {
-        (yyval.no) = criarNo("ID_ARRAY", (yyvsp[-3].str), linha);
-        adicionarFilho((yyval.no), (yyvsp[-1].no));
+        (yyval.no) = criarNoComFilhos(ctx, NO_ID_ARRAY, (yyvsp[-3].atomo), ctx->lexico.linha, 1, (yyvsp[-1].no));
     }
-#line 1743 "cminus.tab.c"
+#line 1706 "cminus.tab.c"
     break;
 
 
-#line 1747 "cminus.tab.c"
+#line 1710 "cminus.tab.c"
 
       default: break;
     }
@@ -1790,7 +1753,7 @@ yyerrlab:
   if (!yyerrstatus)
     {
       ++yynerrs;
-      yyerror (YY_("syntax error"));
+      yyerror (scanner, ctx, YY_("syntax error"));
     }
 
   if (yyerrstatus == 3)
@@ -1807,7 +1770,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval);
+                      yytoken, &yylval, scanner, ctx);
           yychar = YYEMPTY;
         }
     }
@@ -1863,7 +1826,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner, ctx);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -1901,7 +1864,7 @@ yyabortlab:
 | yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
 `-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (scanner, ctx, YY_("memory exhausted"));
   yyresult = 2;
   goto yyreturnlab;
 
@@ -1916,7 +1879,7 @@ yyreturnlab:
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval);
+                  yytoken, &yylval, scanner, ctx);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -1925,7 +1888,7 @@ yyreturnlab:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner, ctx);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
@@ -1936,81 +1899,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 371 "cminus.y"
-
+#line 343 "cminus.y"
 
-int main(int argc, char *argv[]) {
-    if (argc == 2) {
-        FILE *fp = fopen(argv[1], "r");
-        if (!fp) {
-            printf("Erro ao abrir arquivo %s\n", argv[1]);
-            return 1;
-        }
-        extern FILE *yyin;
-        yyin = fp;
-
-        /* Desliga debug para saida limpa */
-        yydebug = 0;
-
-        printf("=== COMPILADOR C- ===\n\n");
-        printf("Analisando arquivo: %s\n\n", argv[1]);
-
-        /* Reseta a tabela de tokens e erros */
-        resetarTabelaTokens();
-        resetarErrosLexicos();
-
-        /* FASE 0: Analise Lexica (Tabela de Tokens) */
-        printf("--- FASE 0: ANALISE LEXICA ---\n");
-
-        /* FASE 1: Analise Sintatica (constrói a árvore e captura tokens) */
-        printf("--- FASE 1: ANALISE SINTATICA ---\n");
-        int resultado = yyparse();
-        
-        /* Imprime a tabela de tokens após a análise sintática */
-        imprimirTabelaTokens();
-        
-        /* Imprime erros léxicos encontrados */
-        imprimirErrosLexicos();
-        
-        if (resultado == 0) {
-            printf("Analise sintatica concluida com sucesso!\n\n");
-            
-            /* FASE 2: Analise Semantica */
-            printf("--- FASE 2: ANALISE SEMANTICA ---\n");
-            int erros = analisarSemantica(raiz);
-            
-            if (erros == 0) {
-                printf("Analise semantica concluida sem erros!\n");
-            } else {
-                printf("\nTotal de erros semanticos: %d\n", erros);
-            }
-            
-            /* Imprime Arvore Sintatica */
-            printf("\n--- ARVORE SINTATICA ---\n");
-            imprimirArvore(raiz, 0);
-            
-            /* FASE 3: Geracao de Codigo Intermediario */
-            printf("\n--- FASE 3: GERACAO DE CODIGO INTERMEDIARIO ---\n");
-            int numInstrucoes = gerarCodigoIntermediario(raiz);
-            printf("Codigo intermediario gerado: %d instrucoes\n", numInstrucoes);
-            
-            /* Imprime Codigo Intermediario */
-            imprimirCodigoIntermediario();
-            
-            /* Imprime Tabela de Simbolos */
-            imprimirTabelaSimbolos();
-            
-            /* Libera memoria */
-            liberarCodigoIntermediario();
-            liberarTabelaSimbolos();
-        } else {
-            printf("\nCompilacao abortada devido a erros sintaticos.\n");
-        }
-        
-        fclose(fp);
-    } else {
-        printf("Uso: %s <arquivo.cm>\n", argv[0]);
-        return 1;
-    }
-    return 0;
-}
@@ -44,6 +44,13 @@
 #if YYDEBUG
 extern int yydebug;
 #endif
+/* "%code requires" blocks.  */
+#line 15 "cminus.y"
+
+#include "atomos.h"
+#include "contexto.h"
+
+#line 54 "cminus.tab.h"
 
 /* Token kinds.  */
 #ifndef YYTOKENTYPE
@@ -89,13 +96,13 @@ extern int yydebug;
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 38 "cminus.y"
+#line 45 "cminus.y"
 
-    void* no;   /* Ponteiro para NoArvore */
-    char* str;  /* String (identificadores) */
-    int num;    /* Numero inteiro */
+    NoId no;      /* Indice do no na arvore */
+    Atomo atomo;  /* Identificador internado */
+    int num;      /* Numero inteiro */
 
-#line 99 "cminus.tab.h"
+#line 106 "cminus.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -104,10 +111,19 @@ typedef union YYSTYPE YYSTYPE;
 #endif
 
 
-extern YYSTYPE yylval;
 
 
-int yyparse (void);
+int yyparse (void *scanner, ContextoCompilador *ctx);
+
+/* "%code provides" blocks.  */
+#line 20 "cminus.y"
+
+/* Funcoes do scanner reentrante (lex.yy.c) */
+int yylex(YYSTYPE *yylval_param, void *yyscanner);
+char *yyget_text(void *yyscanner);
+
+void yyerror(void *scanner, ContextoCompilador *ctx, const char *s);
 
+#line 128 "cminus.tab.h"
 
 #endif /* !YY_YY_CMINUS_TAB_H_INCLUDED  */
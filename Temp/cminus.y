@@ -3,46 +3,53 @@
 #include <stdlib.h>
 #include <string.h>
 #include "arvore.h"
-#include "simbolos.h"
-#include "semantico.h"
-#include "intermediario.h"
 
-/* Funcoes externas do scanner */
-extern int yylex();
-extern int linha;
+/* Flag de debug do Bison */
+int yydebug;
 
-/* Funcoes externas da tabela de tokens (do scanner) */
-extern void imprimirTabelaTokens(void);
-extern void resetarTabelaTokens(void);
-extern void imprimirErrosLexicos(void);
-extern void resetarErrosLexicos(void);
+/* A pilha do parser cresce no heap conforme a necessidade; o limite padrao
+   (10000) abortava expressoes e cadeias de else-if muito aninhadas */
+#define YYMAXDEPTH 50000000
+%}
 
-/* Raiz da arvore sintatica - sera preenchida durante o parsing */
-NoArvore* raiz = NULL;
+%code requires {
+#include "atomos.h"
+#include "contexto.h"
+}
 
-/* Flag de debug do Bison */
-int yydebug;
+%code provides {
+/* Funcoes do scanner reentrante (lex.yy.c) */
+int yylex(YYSTYPE *yylval_param, void *yyscanner);
+char *yyget_text(void *yyscanner);
 
-/* Variavel externa do Flex com o token atual */
-extern char *yytext;
+void yyerror(void *scanner, ContextoCompilador *ctx, const char *s);
+}
 
-void yyerror(char *s) {
-    if (yytext && yytext[0] != '\0') {
-        fprintf(stderr, "ERRO SINTATICO: '%s' (esperado: %s) LINHA: %d\n", yytext, s, linha);
+%code {
+void yyerror(void *scanner, ContextoCompilador *ctx, const char *s) {
+    /* Token atual do scanner desta compilacao */
+    const char *texto = yyget_text(scanner);
+    if (texto && texto[0] != '\0') {
+        fprintf(ctx->erros, "ERRO SINTATICO: '%s' (esperado: %s) LINHA: %d\n", texto, s, ctx->lexico.linha);
     } else {
-        fprintf(stderr, "ERRO SINTATICO: %s LINHA: %d\n", s, linha);
+        fprintf(ctx->erros, "ERRO SINTATICO: %s LINHA: %d\n", s, ctx->lexico.linha);
     }
 }
-%}
+}
+
+/* Parser reentrante: o estado vem do scanner e do contexto da compilacao */
+%define api.pure full
+%lex-param {void *scanner}
+%parse-param {void *scanner} {ContextoCompilador *ctx}
 
 %union {
-    void* no;   /* Ponteiro para NoArvore */
-    char* str;  /* String (identificadores) */
-    int num;    /* Numero inteiro */
+    NoId no;      /* Indice do no na arvore */
+    Atomo atomo;  /* Identificador internado */
+    int num;      /* Numero inteiro */
 }
 
 /* --- Tokens (terminais) vindos do scanner --- */
-%token <str> ID
+%token <atomo> ID
 %token <num> NUM
 %token IF ELSE WHILE RETURN INT VOID
 %token MAIS MENOS VEZES DIVIDIDO
@@ -64,265 +71,235 @@ void yyerror(char *s) {
 
 /* Programa e uma lista de declaracoes */
 programa:
-    declaracao_lista   { raiz = $1; }
+    declaracao_lista   { fecharLista(ctx, $1); ctx->raiz = $1; }
 ;
 
-/* Lista de declaracoes (pelo menos uma) */
+/* Lista de declaracoes (pelo menos uma), num unico no plano; quem usa a
+   lista chama fecharLista quando ela termina */
 declaracao_lista:
     declaracao_lista declaracao {
-        $$ = criarNo("DECL_LIST", NULL, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $2);
+        adicionarFilho(ctx, $1, $2);
+        $$ = $1;
+    }
+  | declaracao {
+        $$ = criarNo(ctx, NO_DECL_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, $$, $1);
     }
-  | declaracao { $$ = $1; }
 ;
 
-/* Uma declaracao pode ser de variavel ou de funcao */
+/* Uma declaracao pode ser de variavel ou de funcao (sem no proprio: o
+   DECL so aparece na impressao detalhada) */
 declaracao:
-    var_declaracao {
-        $$ = criarNo("DECL", NULL, linha);
-        adicionarFilho($$, $1);
-    }
-  | fun_declaracao {
-        $$ = criarNo("DECL", NULL, linha);
-        adicionarFilho($$, $1);
-    }
+    var_declaracao { $$ = $1; }
+  | fun_declaracao { $$ = $1; }
 ;
 
 /* Declaracao de variavel simples ou array */
 var_declaracao:
     tipo_especificador ID PONTOVIRGULA {
-        $$ = criarNo("VAR", $2, linha);
-        adicionarFilho($$, $1);
+        $$ = criarNoComFilhos(ctx, NO_VAR, $2, ctx->lexico.linha, 1, $1);
     }
   | tipo_especificador ID ABRECOLCHETE NUM FECHACOLCHETE PONTOVIRGULA {
         char numstr[16]; 
         sprintf(numstr, "%d", $4);
-        $$ = criarNo("ARRAY_VAR", $2, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, criarNo("TAM", numstr, linha));
+        NoId tam = criarNo(ctx, NO_TAM, internar(&ctx->atomos, numstr), ctx->lexico.linha);
+        $$ = criarNoComFilhos(ctx, NO_ARRAY_VAR, $2, ctx->lexico.linha, 2, $1, tam);
     }
 ;
 
 /* Especificador de tipo: int ou void */
 tipo_especificador:
-    INT  { $$ = criarNo("TIPO", "int", linha); }
-  | VOID { $$ = criarNo("TIPO", "void", linha); }
+    INT  { $$ = criarNo(ctx, NO_TIPO, ATOMO_INT, ctx->lexico.linha); }
+  | VOID { $$ = criarNo(ctx, NO_TIPO, ATOMO_VOID, ctx->lexico.linha); }
 ;
 
 /* Declaracao de funcao */
 fun_declaracao:
     tipo_especificador ID ABREPARENTESES parametros FECHAPARENTESES corpo_funcao {
-        $$ = criarNo("FUN_DEF", $2, linha);
-        adicionarFilho($$, $1);   /* tipo de retorno */
-        adicionarFilho($$, $4);   /* parametros */
-        adicionarFilho($$, $6);   /* corpo */
+        $$ = criarNoComFilhos(ctx, NO_FUN_DEF, $2, ctx->lexico.linha, 3,
+                              $1,  /* tipo de retorno */
+                              $4,  /* parametros */
+                              $6);  /* corpo */
     }
 ;
 
 /* Parametros: void ou lista de parametros */
 parametros:
-    VOID { $$ = criarNo("PARAMS", "void", linha); }
+    VOID { $$ = criarNo(ctx, NO_PARAMS, ATOMO_VOID, ctx->lexico.linha); }
   | parametro_lista {
-        $$ = criarNo("PARAMS", NULL, linha);
-        adicionarFilho($$, $1);
+        fecharLista(ctx, $1);
+        $$ = criarNoComFilhos(ctx, NO_PARAMS, ATOMO_NULO, ctx->lexico.linha, 1, $1);
     }
 ;
 
-/* Lista de parametros separados por virgula */
+/* Lista de parametros separados por virgula (no plano) */
 parametro_lista:
     parametro_lista VIRGULA parametro {
-        $$ = criarNo("PARAM_LIST", NULL, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        adicionarFilho(ctx, $1, $3);
+        $$ = $1;
+    }
+  | parametro {
+        $$ = criarNo(ctx, NO_PARAM_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, $$, $1);
     }
-  | parametro { $$ = $1; }
 ;
 
 /* Parametro simples ou array */
 parametro:
     tipo_especificador ID {
-        $$ = criarNo("PARAM", $2, linha);
-        adicionarFilho($$, $1);
+        $$ = criarNoComFilhos(ctx, NO_PARAM, $2, ctx->lexico.linha, 1, $1);
     }
   | tipo_especificador ID ABRECOLCHETE FECHACOLCHETE {
-        $$ = criarNo("PARAM_ARRAY", $2, linha);
-        adicionarFilho($$, $1);
+        $$ = criarNoComFilhos(ctx, NO_PARAM_ARRAY, $2, ctx->lexico.linha, 1, $1);
     }
 ;
 
 /* Corpo da funcao: bloco com declaracoes e comandos */
 corpo_funcao:
     ABRECHAVE declaracao_lista comando_lista FECHACHAVE {
-        $$ = criarNo("CORPO", NULL, linha);
-        adicionarFilho($$, $2);
-        adicionarFilho($$, $3);
+        fecharLista(ctx, $2);
+        fecharLista(ctx, $3);
+        $$ = criarNoComFilhos(ctx, NO_CORPO, ATOMO_NULO, ctx->lexico.linha, 2, $2, $3);
     }
   | ABRECHAVE comando_lista FECHACHAVE {
-        $$ = criarNo("CORPO", NULL, linha);
-        adicionarFilho($$, $2);
+        fecharLista(ctx, $2);
+        $$ = criarNoComFilhos(ctx, NO_CORPO, ATOMO_NULO, ctx->lexico.linha, 1, $2);
     }
 ;
 
-/* Lista de comandos (pode ser vazia) */
+/* Lista de comandos (pode ser vazia; no plano) */
 comando_lista:
     comando_lista comando {
-        $$ = criarNo("CMD_LIST", NULL, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $2);
+        adicionarFilho(ctx, $1, $2);
+        $$ = $1;
+    }
+  | comando {
+        $$ = criarNo(ctx, NO_CMD_LIST, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, $$, $1);
     }
-  | comando { $$ = $1; }
   | /* vazio */ {
-        $$ = criarNo("CMD_LIST_VAZIA", NULL, linha);
+        $$ = criarNo(ctx, NO_CMD_LIST_VAZIA, ATOMO_NULO, ctx->lexico.linha);
     }
 ;
 
-/* Tipos de comandos */
+/* Tipos de comandos (sem no proprio: o CMD so aparece na impressao
+   detalhada) */
 comando:
-    expressao_comando {
-        $$ = criarNo("CMD", NULL, linha);
-        adicionarFilho($$, $1);
-    }
-  | selecao_comando {
-        $$ = criarNo("CMD", NULL, linha);
-        adicionarFilho($$, $1);
-    }
-  | iteracao_comando {
-        $$ = criarNo("CMD", NULL, linha);
-        adicionarFilho($$, $1);
-    }
-  | retorno_comando {
-        $$ = criarNo("CMD", NULL, linha);
-        adicionarFilho($$, $1);
-    }
-  | bloco_comando {
-        $$ = $1;
-    }
+    expressao_comando { $$ = $1; }
+  | selecao_comando   { $$ = $1; }
+  | iteracao_comando  { $$ = $1; }
+  | retorno_comando   { $$ = $1; }
+  | bloco_comando     { $$ = $1; }
 ;
 
 /* Bloco de comandos com chaves */
 bloco_comando:
     ABRECHAVE declaracao_lista comando_lista FECHACHAVE {
-        $$ = criarNo("BLOCO", NULL, linha);
-        adicionarFilho($$, $2);
-        adicionarFilho($$, $3);
+        fecharLista(ctx, $2);
+        fecharLista(ctx, $3);
+        $$ = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 2, $2, $3);
     }
   | ABRECHAVE comando_lista FECHACHAVE {
-        $$ = criarNo("BLOCO", NULL, linha);
-        adicionarFilho($$, $2);
+        fecharLista(ctx, $2);
+        $$ = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 1, $2);
     }
   | ABRECHAVE declaracao_lista FECHACHAVE {
-        $$ = criarNo("BLOCO", NULL, linha);
-        adicionarFilho($$, $2);
+        fecharLista(ctx, $2);
+        $$ = criarNoComFilhos(ctx, NO_BLOCO, ATOMO_NULO, ctx->lexico.linha, 1, $2);
     }
   | ABRECHAVE FECHACHAVE {
-        $$ = criarNo("BLOCO_VAZIO", NULL, linha);
+        $$ = criarNo(ctx, NO_BLOCO_VAZIO, ATOMO_NULO, ctx->lexico.linha);
     }
 ;
 
 /* Comando de expressao (expressao seguida de ;) */
 expressao_comando:
     expressao PONTOVIRGULA {
-        $$ = criarNo("EXP_CMD", NULL, linha);
-        adicionarFilho($$, $1);
+        $$ = criarNoComFilhos(ctx, NO_EXP_CMD, ATOMO_NULO, ctx->lexico.linha, 1, $1);
     }
   | PONTOVIRGULA {
-        $$ = criarNo("EXP_CMD_VAZIO", NULL, linha);
+        $$ = criarNo(ctx, NO_EXP_CMD_VAZIO, ATOMO_NULO, ctx->lexico.linha);
     }
 ;
 
 /* Comando de selecao: if e if-else */
 selecao_comando:
     IF ABREPARENTESES expressao FECHAPARENTESES comando ELSE comando {
-        $$ = criarNo("IFELSE", NULL, linha);
-        adicionarFilho($$, $3);  /* condicao */
-        adicionarFilho($$, $5);  /* bloco then */
-        adicionarFilho($$, $7);  /* bloco else */
+        $$ = criarNoComFilhos(ctx, NO_IFELSE, ATOMO_NULO, ctx->lexico.linha, 3,
+                              $3,  /* condicao */
+                              $5,  /* bloco then */
+                              $7);  /* bloco else */
     }
   | IF ABREPARENTESES expressao FECHAPARENTESES comando {
-        $$ = criarNo("IF", NULL, linha);
-        adicionarFilho($$, $3);  /* condicao */
-        adicionarFilho($$, $5);  /* bloco then */
+        $$ = criarNoComFilhos(ctx, NO_IF, ATOMO_NULO, ctx->lexico.linha, 2,
+                              $3,  /* condicao */
+                              $5);  /* bloco then */
     }
 ;
 
 /* Comando de iteracao: while */
 iteracao_comando:
     WHILE ABREPARENTESES expressao FECHAPARENTESES comando {
-        $$ = criarNo("WHILE", NULL, linha);
-        adicionarFilho($$, $3);  /* condicao */
-        adicionarFilho($$, $5);  /* corpo do loop */
+        $$ = criarNoComFilhos(ctx, NO_WHILE, ATOMO_NULO, ctx->lexico.linha, 2,
+                              $3,  /* condicao */
+                              $5);  /* corpo do loop */
     }
 ;
 
 /* Comando de retorno */
 retorno_comando:
     RETURN PONTOVIRGULA {
-        $$ = criarNo("RETURN", NULL, linha);
+        $$ = criarNo(ctx, NO_RETURN, ATOMO_NULO, ctx->lexico.linha);
     }
   | RETURN expressao PONTOVIRGULA {
-        $$ = criarNo("RETURN", NULL, linha);
-        adicionarFilho($$, $2);
+        $$ = criarNoComFilhos(ctx, NO_RETURN, ATOMO_NULO, ctx->lexico.linha, 1, $2);
     }
 ;
 
 /* Expressao: atribuicao ou expressao simples */
 expressao:
     var ATRIBUICAO expressao {
-        $$ = criarNo("ATRIB", NULL, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        $$ = criarNoComFilhos(ctx, NO_ATRIB, ATOMO_NULO, ctx->lexico.linha, 2, $1, $3);
     }
   | simples_expressao { $$ = $1; }
 ;
 
-/* Expressao simples: comparacao ou soma */
+/* Expressao simples: comparacao (dobrada se os lados forem literais) ou soma */
 simples_expressao:
     soma_expressao relacional soma_expressao {
-        $$ = criarNo("REL", NULL, linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $2);
-        adicionarFilho($$, $3);
+        $$ = criarRelacional(ctx, ctx->lexico.linha, $1, $2, $3);
     }
   | soma_expressao { $$ = $1; }
 ;
 
 /* Operadores relacionais */
 relacional:
-      MENOR      { $$ = criarNo("OP", "<", linha); }
-    | MAIOR      { $$ = criarNo("OP", ">", linha); }
-    | MENORIGUAL { $$ = criarNo("OP", "<=", linha); }
-    | MAIORIGUAL { $$ = criarNo("OP", ">=", linha); }
-    | IGUAL      { $$ = criarNo("OP", "==", linha); }
-    | DIFERENTE  { $$ = criarNo("OP", "!=", linha); }
+      MENOR      { $$ = criarNo(ctx, NO_OP, ATOMO_MENOR, ctx->lexico.linha); }
+    | MAIOR      { $$ = criarNo(ctx, NO_OP, ATOMO_MAIOR, ctx->lexico.linha); }
+    | MENORIGUAL { $$ = criarNo(ctx, NO_OP, ATOMO_MENORIGUAL, ctx->lexico.linha); }
+    | MAIORIGUAL { $$ = criarNo(ctx, NO_OP, ATOMO_MAIORIGUAL, ctx->lexico.linha); }
+    | IGUAL      { $$ = criarNo(ctx, NO_OP, ATOMO_IGUAL, ctx->lexico.linha); }
+    | DIFERENTE  { $$ = criarNo(ctx, NO_OP, ATOMO_DIFERENTE, ctx->lexico.linha); }
 ;
 
-/* Soma e subtracao */
+/* Soma e subtracao (contas entre dois literais ja saem prontas) */
 soma_expressao:
     soma_expressao MAIS termo {
-        $$ = criarNo("SOMA", "+", linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        $$ = criarOperacao(ctx, NO_SOMA, ATOMO_MAIS, ctx->lexico.linha, $1, $3);
     }
   | soma_expressao MENOS termo {
-        $$ = criarNo("SUB", "-", linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        $$ = criarOperacao(ctx, NO_SUB, ATOMO_MENOS, ctx->lexico.linha, $1, $3);
     }
   | termo { $$ = $1; }
 ;
 
-/* Multiplicacao e divisao */
+/* Multiplicacao e divisao (idem) */
 termo:
     termo VEZES fator {
-        $$ = criarNo("MULT", "*", linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        $$ = criarOperacao(ctx, NO_MULT, ATOMO_VEZES, ctx->lexico.linha, $1, $3);
     }
   | termo DIVIDIDO fator {
-        $$ = criarNo("DIV", "/", linha);
-        adicionarFilho($$, $1);
-        adicionarFilho($$, $3);
+        $$ = criarOperacao(ctx, NO_DIV, ATOMO_DIVIDIDO, ctx->lexico.linha, $1, $3);
     }
   | fator { $$ = $1; }
 ;
@@ -331,28 +308,24 @@ termo:
 fator:
     ABREPARENTESES expressao FECHAPARENTESES { $$ = $2; }
   | var { $$ = $1; }
-  | NUM {
-        char numstr[16];
-        sprintf(numstr, "%d", $1);
-        $$ = criarNo("NUM", numstr, linha);
-    }
+  | NUM { $$ = criarNum(ctx, $1, ctx->lexico.linha); }
   | ID ABREPARENTESES FECHAPARENTESES {
-        $$ = criarNo("CHAMADA_FUNCAO", $1, linha);
+        $$ = criarNo(ctx, NO_CHAMADA_FUNCAO, $1, ctx->lexico.linha);
     }
   | ID ABREPARENTESES args_funcao FECHAPARENTESES {
-        $$ = criarNo("CHAMADA_FUNCAO", $1, linha);
-        adicionarFilho($$, $3);
+        fecharLista(ctx, $3);
+        $$ = criarNoComFilhos(ctx, NO_CHAMADA_FUNCAO, $1, ctx->lexico.linha, 1, $3);
     }
 ;
 
 /* Argumentos de funcao */
 args_funcao:
     expressao {
-        $$ = criarNo("ARGS", NULL, linha);
-        adicionarFilho($$, $1);
+        $$ = criarNo(ctx, NO_ARGS, ATOMO_NULO, ctx->lexico.linha);
+        adicionarFilho(ctx, $$, $1);
     }
   | args_funcao VIRGULA expressao {
-        adicionarFilho($1, $3);
+        adicionarFilho(ctx, $1, $3);
         $$ = $1;
     }
 ;
@@ -360,88 +333,11 @@ args_funcao:
 /* Variavel simples ou acesso a array */
 var:
       ID {
-        $$ = criarNo("ID", $1, linha);
+        $$ = criarNo(ctx, NO_ID, $1, ctx->lexico.linha);
     }
     | ID ABRECOLCHETE expressao FECHACOLCHETE {
-        $$ = criarNo("ID_ARRAY", $1, linha);
-        adicionarFilho($$, $3);
+        $$ = criarNoComFilhos(ctx, NO_ID_ARRAY, $1, ctx->lexico.linha, 1, $3);
     }
 ;
 
 %%
-
-int main(int argc, char *argv[]) {
-    if (argc == 2) {
-        FILE *fp = fopen(argv[1], "r");
-        if (!fp) {
-            printf("Erro ao abrir arquivo %s\n", argv[1]);
-            return 1;
-        }
-        extern FILE *yyin;
-        yyin = fp;
-
-        /* Desliga debug para saida limpa */
-        yydebug = 0;
-
-        printf("=== COMPILADOR C- ===\n\n");
-        printf("Analisando arquivo: %s\n\n", argv[1]);
-
-        /* Reseta a tabela de tokens e erros */
-        resetarTabelaTokens();
-        resetarErrosLexicos();
-
-        /* FASE 0: Analise Lexica (Tabela de Tokens) */
-        printf("--- FASE 0: ANALISE LEXICA ---\n");
-
-        /* FASE 1: Analise Sintatica (constrói a árvore e captura tokens) */
-        printf("--- FASE 1: ANALISE SINTATICA ---\n");
-        int resultado = yyparse();
-        
-        /* Imprime a tabela de tokens após a análise sintática */
-        imprimirTabelaTokens();
-        
-        /* Imprime erros léxicos encontrados */
-        imprimirErrosLexicos();
-        
-        if (resultado == 0) {
-            printf("Analise sintatica concluida com sucesso!\n\n");
-            
-            /* FASE 2: Analise Semantica */
-            printf("--- FASE 2: ANALISE SEMANTICA ---\n");
-            int erros = analisarSemantica(raiz);
-            
-            if (erros == 0) {
-                printf("Analise semantica concluida sem erros!\n");
-            } else {
-                printf("\nTotal de erros semanticos: %d\n", erros);
-            }
-            
-            /* Imprime Arvore Sintatica */
-            printf("\n--- ARVORE SINTATICA ---\n");
-            imprimirArvore(raiz, 0);
-            
-            /* FASE 3: Geracao de Codigo Intermediario */
-            printf("\n--- FASE 3: GERACAO DE CODIGO INTERMEDIARIO ---\n");
-            int numInstrucoes = gerarCodigoIntermediario(raiz);
-            printf("Codigo intermediario gerado: %d instrucoes\n", numInstrucoes);
-            
-            /* Imprime Codigo Intermediario */
-            imprimirCodigoIntermediario();
-            
-            /* Imprime Tabela de Simbolos */
-            imprimirTabelaSimbolos();
-            
-            /* Libera memoria */
-            liberarCodigoIntermediario();
-            liberarTabelaSimbolos();
-        } else {
-            printf("\nCompilacao abortada devido a erros sintaticos.\n");
-        }
-        
-        fclose(fp);
-    } else {
-        printf("Uso: %s <arquivo.cm>\n", argv[0]);
-        return 1;
-    }
-    return 0;
-}
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compilador.h"
+#include "contexto.h"
+#include "semantico.h"
+#include "fonte.h"
+#include "propagacao.h"
+#include "saida.h"
+#include "cminus.tab.h"
+
+int compilarArquivo(const OpcoesCompilacao *op, const char *arquivo, FILE *mensagens,
+                    FILE *erros, FILE *artefatos, size_t *bytesFonte) {
+    *bytesFonte = 0;
+
+    /* Mapeia o arquivo e faz o scanner ler direto dele, sem copias */
+    Fonte fonte;
+    int aberta = abrirFonte(&fonte, arquivo);
+    if (aberta < 0) {
+        fprintf(mensagens, "Erro: arquivo %s maior que %lu bytes\n", arquivo,
+                (unsigned long) FONTE_TAMANHO_MAXIMO);
+        return 1;
+    }
+    if (aberta == 0) {
+        fprintf(mensagens, "Erro ao abrir arquivo %s\n", arquivo);
+        return 1;
+    }
+    *bytesFonte = fonte.tamanho;
+
+    /* Os artefatos passam pelo escritor bufferizado; as mensagens das fases
+       continuam no fprintf, por isso a saida e descarregada entre as fases */
+    Saida saida;
+    saidaAbrir(&saida, artefatos, op->saidaAssincrona);
+
+    /* Todo o estado da compilacao fica no contexto */
+    ContextoCompilador ctx;
+    iniciarContexto(&ctx);
+    ctx.mensagens = mensagens;
+    ctx.erros = erros;
+    ctx.numThreads = op->numThreads;
+    iniciarScannerEmMemoria(&ctx, fonte.texto, fonte.tamanho);
+
+    fprintf(mensagens, "=== COMPILADOR C- ===\n\n");
+    fprintf(mensagens, "Analisando arquivo: %s\n\n", arquivo);
+
+    /* Reseta a tabela de tokens e erros */
+    resetarTabelaTokens(&ctx.lexico);
+    resetarErrosLexicos(&ctx.lexico);
+
+    /* FASE 0: Analise Lexica (Tabela de Tokens) */
+    fprintf(mensagens, "--- FASE 0: ANALISE LEXICA ---\n");
+
+    /* Instala os ouvintes do scanner conforme o modo escolhido */
+    FluxoTokens fluxo = { &saida, 0 };
+    if (op->modoTokens == TOKENS_TABELA) {
+        definirOuvinteTokens(&ctx.lexico, ouvinteTabelaTokens, &ctx.lexico);
+    } else if (op->modoTokens == TOKENS_FLUXO) {
+        saidaTexto(&saida, CABECALHO_TOKENS);
+        saidaDescarregar(&saida);
+        definirOuvinteTokens(&ctx.lexico, ouvinteFluxoTokens, &fluxo);
+    } else {
+        definirOuvinteTokens(&ctx.lexico, NULL, NULL);
+    }
+    definirOuvinteErrosLexicos(&ctx.lexico, ouvinteTabelaErros, &ctx.lexico);
+
+    /* FASE 1: Analise Sintatica (constrói a árvore e captura tokens) */
+    fprintf(mensagens, "--- FASE 1: ANALISE SINTATICA ---\n");
+    int resultado = yyparse(ctx.scanner, &ctx);
+
+    /* Imprime a tabela de tokens após a análise sintática */
+    if (op->modoTokens == TOKENS_TABELA) {
+        imprimirTabelaTokens(&ctx.lexico, &saida);
+    }
+    saidaDescarregar(&saida);
+
+    /* Imprime erros léxicos encontrados */
+    imprimirErrosLexicos(&ctx.lexico, mensagens);
+
+    if (resultado == 0) {
+        fprintf(mensagens, "Analise sintatica concluida com sucesso!\n\n");
+
+        /* FASE 2: Analise Semantica */
+        if (op->ultimaFase >= PARAR_APOS_SEMA) {
+            fprintf(mensagens, "--- FASE 2: ANALISE SEMANTICA ---\n");
+            int errosSemanticos = analisarSemantica(&ctx);
+
+            if (errosSemanticos == 0) {
+                fprintf(mensagens, "Analise semantica concluida sem erros!\n");
+            } else {
+                fprintf(mensagens, "\nTotal de erros semanticos: %d\n", errosSemanticos);
+            }
+        }
+
+        /* Imprime Arvore Sintatica */
+        if (op->emitir & EMITIR_AST) {
+            saidaTexto(&saida, "\n--- ARVORE SINTATICA ---\n");
+            imprimirArvore(&ctx, &saida, ctx.raiz, 0, op->astDetalhada);
+            saidaDescarregar(&saida);
+        }
+
+        /* FASE 3: Geracao de Codigo Intermediario */
+        if (op->ultimaFase >= PARAR_APOS_IR) {
+            fprintf(mensagens, "\n--- FASE 3: GERACAO DE CODIGO INTERMEDIARIO ---\n");
+            int numInstrucoes = gerarCodigoIntermediario(&ctx);
+            fprintf(mensagens, "Codigo intermediario gerado: %d instrucoes\n", numInstrucoes);
+            construirGrafoFluxo(&ctx.fluxo, &ctx.codigo);
+
+            /* O codigo passa pela forma SSA (onde e otimizado) e volta, com um grafo novo */
+            int numPhis = construirSSA(&ctx);
+            fprintf(mensagens, "Forma SSA: %d phis\n", numPhis);
+            if (op->otimizar) {
+                int removidas = propagarConstantes(&ctx);
+                fprintf(mensagens, "Propagacao de constantes: %d instrucoes removidas\n", removidas);
+            }
+            sairSSA(&ctx);
+            fprintf(mensagens, "Grafo de fluxo: %d blocos basicos\n", ctx.fluxo.totalBlocos);
+
+            /* Imprime Codigo Intermediario */
+            if (op->emitir & EMITIR_IR) {
+                imprimirCodigoIntermediario(&ctx, &saida);
+            }
+            if (op->emitir & EMITIR_FLUXO) {
+                imprimirGrafoFluxo(&ctx.fluxo, &ctx.atomos, &saida);
+            }
+            if (op->emitir & EMITIR_SSA) {
+                imprimirSSA(&ctx.ssa, &ctx.atomos, &saida);
+            }
+        }
+
+        /* Imprime Tabela de Simbolos */
+        if (op->ultimaFase >= PARAR_APOS_SEMA && (op->emitir & EMITIR_SIMBOLOS)) {
+            imprimirTabelaSimbolos(&ctx.simbolos, &ctx.atomos, &saida);
+        }
+
+        /* Libera memoria */
+        liberarSSA(&ctx.ssa);
+        liberarGrafoFluxo(&ctx.fluxo);
+        liberarCodigoIntermediario(&ctx);
+        liberarTabelaSimbolos(&ctx.simbolos);
+        saidaDescarregar(&saida);
+    } else {
+        fprintf(mensagens, "\nCompilacao abortada devido a erros sintaticos.\n");
+    }
+
+    /* Libera a arvore em bloco */
+    if (op->emitir & EMITIR_STATS) {
+        imprimirEstatisticasTokens(&ctx.lexico, &saida);
+        imprimirEstatisticasArvore(&saida, &ctx.arvore);
+    }
+    saidaFechar(&saida);
+
+    finalizarScanner(&ctx);
+    liberarContexto(&ctx);
+    fecharFonte(&fonte);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#ifndef COMPILADOR_H
+#define COMPILADOR_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Ultima fase executada */
+typedef enum {
+    PARAR_APOS_PARSE,
+    PARAR_APOS_SEMA,
+    PARAR_APOS_IR
+} UltimaFase;
+
+/* Artefatos que podem ser emitidos (combinaveis em --emit) */
+enum {
+    EMITIR_TOKENS   = 1 << 0,
+    EMITIR_AST      = 1 << 1,
+    EMITIR_IR       = 1 << 2,
+    EMITIR_SIMBOLOS = 1 << 3,
+    EMITIR_STATS    = 1 << 4,
+    EMITIR_FLUXO    = 1 << 5,
+    EMITIR_SSA      = 1 << 6,
+    EMITIR_TUDO     = (1 << 7) - 1
+};
+
+/* Como os tokens reconhecidos sao gravados */
+typedef enum {
+    TOKENS_TABELA,   /* Acumula e imprime a tabela apos o parsing (padrao) */
+    TOKENS_FLUXO,    /* Escreve cada token assim que e reconhecido */
+    TOKENS_NENHUM    /* Nao grava tokens */
+} ModoTokens;
+
+/* O que fazer com cada arquivo (iguais para todos os arquivos de um lote) */
+typedef struct {
+    UltimaFase ultimaFase;    /* --stop-after */
+    int emitir;               /* Mascara EMITIR_* (--emit) */
+    ModoTokens modoTokens;    /* --tokens */
+    int astDetalhada;         /* --ast=detalhada: com os nos DECL e CMD */
+    int saidaAssincrona;      /* --async-output */
+    int numThreads;           /* Threads das fases por funcao (1 = em serie) */
+    int otimizar;             /* -O1: propagacao de constantes na forma SSA */
+} OpcoesCompilacao;
+
+/*
+ * compilarArquivo - Roda o pipeline inteiro sobre um arquivo, com um contexto
+ * proprio. As mensagens das fases vao para 'mensagens', os erros sintaticos
+ * para 'erros' e os artefatos para 'artefatos' (podem ser o mesmo arquivo).
+ * Devolve 0 se o fonte pode ser lido; em 'bytesFonte' fica o seu tamanho.
+ */
+int compilarArquivo(const OpcoesCompilacao *op, const char *arquivo, FILE *mensagens,
+                    FILE *erros, FILE *artefatos, size_t *bytesFonte);
+
+#endif
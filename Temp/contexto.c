@@ -0,0 +1,38 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "contexto.h"
+
+void iniciarContexto(ContextoCompilador *ctx) {
+    TabelaAtomos atomos = TABELA_ATOMOS_INICIAL;
+    EstadoLexico lexico = ESTADO_LEXICO_INICIAL;
+    Arvore arvore = ARVORE_INICIAL;
+    TabelaSimbolos simbolos = TABELA_SIMBOLOS_INICIAL;
+    CodigoIntermediario codigo = CODIGO_INTERMEDIARIO_INICIAL;
+    GrafoFluxo fluxo = GRAFO_FLUXO_INICIAL;
+    FormaSSA ssa = FORMA_SSA_INICIAL;
+
+    ctx->atomos = atomos;
+    ctx->lexico = lexico;
+    ctx->scanner = NULL;
+    ctx->arvore = arvore;
+    ctx->raiz = NO_NULO;
+    ctx->simbolos = simbolos;
+    ctx->errosSemanticos = 0;
+    ctx->codigo = codigo;
+    ctx->fluxo = fluxo;
+    ctx->ssa = ssa;
+    ctx->mensagens = stdout;
+    ctx->erros = stderr;
+    ctx->numThreads = 1;
+}
+
+void liberarContexto(ContextoCompilador *ctx) {
+    liberarSSA(&ctx->ssa);
+    liberarGrafoFluxo(&ctx->fluxo);
+    liberarCodigoIntermediario(ctx);
+    liberarTabelaSimbolos(&ctx->simbolos);
+    liberarArvore(ctx);
+    resetarTabelaTokens(&ctx->lexico);
+    resetarErrosLexicos(&ctx->lexico);
+    liberarAtomos(&ctx->atomos);
+}
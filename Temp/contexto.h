@@ -0,0 +1,48 @@
+#ifndef CONTEXTO_H
+#define CONTEXTO_H
+
+#include <stdio.h>
+#include "arena.h"
+#include "atomos.h"
+#include "arvore.h"
+#include "simbolos.h"
+#include "tokens.h"
+#include "intermediario.h"
+#include "fluxo.h"
+#include "ssa.h"
+
+/*
+ * Contexto de uma compilacao: reune todo o estado que antes ficava em
+ * variaveis globais (atomos, scanner, arvore, simbolos, codigo gerado
+ * e o seu grafo de fluxo e forma SSA).
+ * Cada compilacao usa o seu, entao varias podem rodar no mesmo processo.
+ */
+typedef struct ContextoCompilador {
+    TabelaAtomos atomos;          /* Nomes internados desta compilacao */
+
+    EstadoLexico lexico;          /* Posicao, ouvintes e tabelas do scanner */
+    void *scanner;                /* yyscan_t do scanner reentrante */
+
+    Arvore arvore;                /* Nos da arvore sintatica */
+    NoId raiz;                    /* Raiz construida pelo parser */
+
+    TabelaSimbolos simbolos;
+    int errosSemanticos;
+
+    CodigoIntermediario codigo;   /* Instrucoes de tres enderecos */
+    GrafoFluxo fluxo;             /* Blocos basicos do codigo */
+    FormaSSA ssa;                 /* Codigo em SSA, por funcao */
+
+    FILE *mensagens;              /* Mensagens das fases e erros semanticos */
+    FILE *erros;                  /* Erros sintaticos */
+
+    int numThreads;               /* Threads da analise e do codigo por funcao */
+} ContextoCompilador;
+
+/* Comeca vazio, em serie, com as mensagens em stdout e os erros em stderr */
+void iniciarContexto(ContextoCompilador *ctx);
+
+/* Libera tudo o que a compilacao alocou (exceto o scanner) */
+void liberarContexto(ContextoCompilador *ctx);
+
+#endif
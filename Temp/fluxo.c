@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "fluxo.h"
+
+/* Capacidade inicial dos vetores de blocos e de funcoes */
+#define CAPACIDADE_INICIAL 64
+
+static void* crescerVetor(void *vetor, int *capacidade, size_t tamanho) {
+    *capacidade = *capacidade ? *capacidade * 2 : CAPACIDADE_INICIAL;
+    vetor = realloc(vetor, tamanho * (size_t) *capacidade);
+    if (vetor == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o grafo de fluxo\n");
+        exit(1);
+    }
+    return vetor;
+}
+
+/* Abre um bloco a partir da instrucao 'inicio' e devolve o seu indice */
+static int abrirBloco(GrafoFluxo *g, int *capacidade, int inicio) {
+    if (g->totalBlocos >= *capacidade) {
+        g->blocos = (BlocoBasico*) crescerVetor(g->blocos, capacidade, sizeof(BlocoBasico));
+    }
+    BlocoBasico *b = &g->blocos[g->totalBlocos];
+    b->inicio = inicio;
+    b->fim = inicio;
+    b->sucessores[0] = b->sucessores[1] = -1;
+    b->numSucessores = 0;
+    b->primeiroPredecessor = 0;
+    b->numPredecessores = 0;
+    return g->totalBlocos++;
+}
+
+static void adicionarSucessor(BlocoBasico *b, int destino) {
+    /* if_false para o rotulo seguinte da uma aresta so */
+    if (b->numSucessores > 0 && b->sucessores[0] == destino) return;
+    b->sucessores[b->numSucessores++] = destino;
+}
+
+/* Instrucao que encerra o bloco: o que vem depois abre outro */
+static int terminaBloco(Operador op) {
+    return op == OP_DESVIO || op == OP_SE_FALSO || op == OP_RETORNO;
+}
+
+/*
+ * dividirBlocos - Percorre as instrucoes uma vez: cada func abre a funcao
+ * e o seu bloco de entrada, e um novo bloco comeca em cada rotulo e depois
+ * de cada desvio ou return
+ */
+static void dividirBlocos(GrafoFluxo *g, const CodigoIntermediario *c) {
+    int capacidadeBlocos = 0;
+    int capacidadeFuncoes = 0;
+    FuncaoFluxo *f = NULL;
+    int atual = -1;   /* Bloco aberto (-1 = fora de funcao) */
+
+    for (int i = 0; i < c->totalInstrucoes; i++) {
+        const Instrucao3Endereco *inst = &c->instrucoes[i];
+        Operador op = (Operador) inst->operador;
+
+        if (op == OP_FUNCAO) {
+            if (g->totalFuncoes >= capacidadeFuncoes) {
+                g->funcoes = (FuncaoFluxo*) crescerVetor(g->funcoes, &capacidadeFuncoes,
+                                                         sizeof(FuncaoFluxo));
+            }
+            f = &g->funcoes[g->totalFuncoes++];
+            f->nome = (Atomo) inst->valores[OPERANDO1];
+            f->instrucaoFuncao = i;
+            f->instrucaoFim = i;
+            f->primeiroBloco = atual = abrirBloco(g, &capacidadeBlocos, i + 1);
+            continue;
+        }
+        if (atual < 0) continue;
+
+        if (op == OP_FIM_FUNCAO) {
+            g->blocos[atual].fim = i;
+            f->instrucaoFim = i;
+            f->numBlocos = g->totalBlocos - f->primeiroBloco;
+            atual = -1;
+            continue;
+        }
+
+        /* Rotulo abre bloco, a menos que o atual ainda esteja vazio; a
+           entrada nunca recebe rotulo, para nao ter predecessores */
+        if (op == OP_ROTULO) {
+            if (i > g->blocos[atual].inicio || atual == f->primeiroBloco) {
+                atual = abrirBloco(g, &capacidadeBlocos, i);
+            }
+            g->blocoRotulo[inst->valores[RESULTADO]] = atual;
+        }
+
+        /* Depois de um desvio vem outro bloco (o endfunc sempre vem depois) */
+        g->blocos[atual].fim = i + 1;
+        if (terminaBloco(op) && (Operador) c->instrucoes[i + 1].operador != OP_FIM_FUNCAO) {
+            atual = abrirBloco(g, &capacidadeBlocos, i + 1);
+        }
+    }
+}
+
+/*
+ * ligarBlocos - Sucessores pela ultima instrucao de cada bloco; depois os
+ * predecessores, contados e distribuidos num vetor unico
+ */
+static void ligarBlocos(GrafoFluxo *g, const CodigoIntermediario *c) {
+    for (int k = 0; k < g->totalFuncoes; k++) {
+        const FuncaoFluxo *f = &g->funcoes[k];
+        int ultimo = f->primeiroBloco + f->numBlocos - 1;
+
+        for (int b = f->primeiroBloco; b <= ultimo; b++) {
+            BlocoBasico *bloco = &g->blocos[b];
+            Operador op = OP_SOMA;
+            int rotulo = 0;
+            if (bloco->fim > bloco->inicio) {
+                const Instrucao3Endereco *inst = &c->instrucoes[bloco->fim - 1];
+                op = (Operador) inst->operador;
+                rotulo = inst->valores[RESULTADO];
+            }
+
+            /* Sem desvio incondicional, segue para o bloco seguinte */
+            if (op != OP_DESVIO && op != OP_RETORNO && b < ultimo) {
+                adicionarSucessor(bloco, b + 1);
+            }
+            if (op == OP_DESVIO || op == OP_SE_FALSO) {
+                adicionarSucessor(bloco, g->blocoRotulo[rotulo]);
+            }
+            for (int s = 0; s < bloco->numSucessores; s++) {
+                g->blocos[bloco->sucessores[s]].numPredecessores++;
+                g->totalArestas++;
+            }
+        }
+    }
+
+    g->predecessores = (int*) malloc(sizeof(int) * (size_t) (g->totalArestas > 0 ? g->totalArestas : 1));
+    if (g->predecessores == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o grafo de fluxo\n");
+        exit(1);
+    }
+    int inicio = 0;
+    for (int b = 0; b < g->totalBlocos; b++) {
+        g->blocos[b].primeiroPredecessor = inicio;
+        inicio += g->blocos[b].numPredecessores;
+        g->blocos[b].numPredecessores = 0;
+    }
+    for (int b = 0; b < g->totalBlocos; b++) {
+        for (int s = 0; s < g->blocos[b].numSucessores; s++) {
+            BlocoBasico *destino = &g->blocos[g->blocos[b].sucessores[s]];
+            g->predecessores[destino->primeiroPredecessor + destino->numPredecessores++] = b;
+        }
+    }
+}
+
+int construirGrafoFluxo(GrafoFluxo *g, const CodigoIntermediario *c) {
+    GrafoFluxo vazio = GRAFO_FLUXO_INICIAL;
+    *g = vazio;
+
+    g->totalRotulos = c->contadorRotulos;
+    g->blocoRotulo = (int*) malloc(sizeof(int) * (size_t) (g->totalRotulos > 0 ? g->totalRotulos : 1));
+    if (g->blocoRotulo == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o grafo de fluxo\n");
+        exit(1);
+    }
+    for (int i = 0; i < g->totalRotulos; i++) {
+        g->blocoRotulo[i] = -1;
+    }
+
+    dividirBlocos(g, c);
+    ligarBlocos(g, c);
+    return g->totalBlocos;
+}
+
+/* Lista de blocos "B1 B4" (ou "-") */
+static void imprimirListaBlocos(Saida *saida, const int *blocos, int n) {
+    if (n == 0) {
+        saidaCaractere(saida, '-');
+    }
+    for (int i = 0; i < n; i++) {
+        if (i > 0) saidaCaractere(saida, ' ');
+        saidaCaractere(saida, 'B');
+        saidaInteiro(saida, blocos[i]);
+    }
+}
+
+void imprimirGrafoFluxo(const GrafoFluxo *g, const TabelaAtomos *atomos, Saida *saida) {
+    saidaTexto(saida, "\n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "                          GRAFO DE FLUXO DE CONTROLE                            \n");
+    saidaTexto(saida, "================================================================================\n");
+
+    for (int k = 0; k < g->totalFuncoes; k++) {
+        const FuncaoFluxo *f = &g->funcoes[k];
+        saidaTexto(saida, "Funcao ");
+        saidaTexto(saida, nomeAtomo(atomos, f->nome));
+        saidaTexto(saida, ": ");
+        saidaInteiro(saida, f->numBlocos);
+        saidaTexto(saida, f->numBlocos == 1 ? " bloco\n" : " blocos\n");
+        saidaTexto(saida, "Bloco    Instrucoes      Sucessores      Predecessores\n");
+        saidaTexto(saida, "--------------------------------------------------------------------------------\n");
+
+        /* Campos alinhados como "%-8s %-15s %-15s %s"; instrucoes numeradas como no codigo */
+        for (int b = f->primeiroBloco; b < f->primeiroBloco + f->numBlocos; b++) {
+            const BlocoBasico *bloco = &g->blocos[b];
+            saidaCaractere(saida, 'B');
+            saidaCampoInteiro(saida, b, 7);
+            saidaCaractere(saida, ' ');
+
+            if (bloco->fim > bloco->inicio) {
+                saidaInteiro(saida, bloco->inicio + 1);
+                saidaCaractere(saida, '-');
+                saidaCampoInteiro(saida, bloco->fim, 14 - saidaLarguraInteiro(bloco->inicio + 1));
+            } else {
+                saidaCampo(saida, "-", 15);
+            }
+            saidaCaractere(saida, ' ');
+
+            if (bloco->numSucessores == 0) {
+                saidaCampo(saida, "-", 15);
+            } else if (bloco->numSucessores == 1) {
+                saidaCaractere(saida, 'B');
+                saidaCampoInteiro(saida, bloco->sucessores[0], 14);
+            } else {
+                saidaCaractere(saida, 'B');
+                saidaInteiro(saida, bloco->sucessores[0]);
+                saidaEscrever(saida, " B", 2);
+                saidaCampoInteiro(saida, bloco->sucessores[1],
+                                  12 - saidaLarguraInteiro(bloco->sucessores[0]));
+            }
+            saidaCaractere(saida, ' ');
+
+            imprimirListaBlocos(saida, &g->predecessores[bloco->primeiroPredecessor],
+                                bloco->numPredecessores);
+            saidaCaractere(saida, '\n');
+        }
+        saidaTexto(saida, "\n");
+    }
+
+    saidaTexto(saida, "================================================================================\n");
+}
+
+/*
+ * liberarGrafoFluxo - Libera memoria alocada
+ */
+void liberarGrafoFluxo(GrafoFluxo *g) {
+    GrafoFluxo vazio = GRAFO_FLUXO_INICIAL;
+    free(g->blocos);
+    free(g->predecessores);
+    free(g->funcoes);
+    free(g->blocoRotulo);
+    *g = vazio;
+}
@@ -0,0 +1,67 @@
+#ifndef FLUXO_H
+#define FLUXO_H
+#include "atomos.h"
+#include "intermediario.h"
+#include "saida.h"
+
+/*
+ * Bloco basico: faixa [inicio, fim) do vetor de instrucoes que so e
+ * executada do comeco ao fim. Um desvio tem no maximo dois destinos (o
+ * bloco seguinte e o rotulo), entao os sucessores ficam no proprio bloco;
+ * os predecessores ficam juntos num vetor do grafo, agrupados por bloco.
+ * Depois de um if_false, sucessores[0] e o bloco seguinte (condicao
+ * verdadeira) e sucessores[1] o do rotulo, exceto se forem o mesmo.
+ */
+typedef struct {
+    int inicio;               /* Primeira instrucao */
+    int fim;                  /* Uma depois da ultima */
+    int sucessores[2];        /* Blocos de destino (-1 = nenhum) */
+    int numSucessores;
+    int primeiroPredecessor;  /* Faixa em 'predecessores' do grafo */
+    int numPredecessores;
+} BlocoBasico;
+
+/* Blocos de uma funcao: o primeiro e a entrada */
+typedef struct {
+    Atomo nome;
+    int primeiroBloco;
+    int numBlocos;
+    int instrucaoFuncao;      /* Indice do func */
+    int instrucaoFim;         /* Indice do endfunc */
+} FuncaoFluxo;
+
+/* Grafo de fluxo de controle de todo o programa */
+typedef struct {
+    BlocoBasico *blocos;      /* Blocos na ordem das instrucoes */
+    int totalBlocos;
+    int *predecessores;       /* Arestas de chegada, agrupadas por bloco */
+    int totalArestas;
+    FuncaoFluxo *funcoes;     /* Funcoes na ordem do fonte */
+    int totalFuncoes;
+    int *blocoRotulo;         /* Bloco que cada rotulo abre */
+    int totalRotulos;
+} GrafoFluxo;
+
+/* Grafo vazio, pronto para uso */
+#define GRAFO_FLUXO_INICIAL { NULL, 0, NULL, 0, NULL, 0, NULL, 0 }
+
+static inline int predecessorBloco(const GrafoFluxo *g, int bloco, int i) {
+    return g->predecessores[g->blocos[bloco].primeiroPredecessor + i];
+}
+
+static inline int blocoDoRotulo(const GrafoFluxo *g, int rotulo) {
+    return g->blocoRotulo[rotulo];
+}
+
+/*
+ * construirGrafoFluxo - Divide as instrucoes de cada funcao em blocos
+ * basicos e liga predecessores e sucessores, em tempo linear no numero de
+ * instrucoes. Devolve o total de blocos.
+ */
+int construirGrafoFluxo(GrafoFluxo *g, const CodigoIntermediario *c);
+
+void imprimirGrafoFluxo(const GrafoFluxo *g, const TabelaAtomos *atomos, Saida *saida);
+
+void liberarGrafoFluxo(GrafoFluxo *g);
+
+#endif
@@ -0,0 +1,138 @@
+/* mmap/MAP_ANONYMOUS mesmo com -std=c99 */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fonte.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * lerFonte - Carrega o arquivo com fread num buffer proprio (usado quando
+ * o mapeamento nao esta disponivel)
+ */
+static int lerFonte(Fonte *fonte, const char *caminho) {
+    FILE *fp = fopen(caminho, "rb");
+    if (!fp) {
+        return 0;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long fim = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (fim < 0) {
+        fclose(fp);
+        return 0;
+    }
+    if ((unsigned long long) fim > FONTE_TAMANHO_MAXIMO) {
+        fclose(fp);
+        return -1;
+    }
+
+    char *texto = (char*) malloc((size_t) fim + 2);
+    if (texto == NULL) {
+        fclose(fp);
+        return 0;
+    }
+
+    fonte->tamanho = fread(texto, 1, (size_t) fim, fp);
+    texto[fonte->tamanho] = '\0';
+    texto[fonte->tamanho + 1] = '\0';
+    fonte->texto = texto;
+    fonte->mapeado = 0;
+    fclose(fp);
+    return 1;
+}
+
+#ifndef _WIN32
+/*
+ * mapearFonte - Mapeia o arquivo em memoria privada (copy-on-write).
+ * Reserva primeiro uma regiao anonima com folga para os dois '\0' e depois
+ * sobrepoe o arquivo no inicio dela: o que sobra da ultima pagina do arquivo
+ * e a pagina anonima seguinte sao zerados pelo kernel.
+ */
+static int mapearFonte(Fonte *fonte, const char *caminho) {
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) {
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        return 0;
+    }
+    if ((unsigned long long) info.st_size > FONTE_TAMANHO_MAXIMO) {
+        close(fd);
+        return -1;
+    }
+
+    size_t tamanho = (size_t) info.st_size;
+    size_t pagina = (size_t) sysconf(_SC_PAGESIZE);
+    size_t total = (tamanho + 2 + pagina - 1) / pagina * pagina;
+
+    char *base = (char*) mmap(NULL, total, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+
+    if (tamanho > 0) {
+        /* O scanner escreve '\0' temporarios no fim de cada lexema: PROT_WRITE + MAP_PRIVATE */
+        void *p = mmap(base, tamanho, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (p == MAP_FAILED) {
+            munmap(base, total);
+            close(fd);
+            return 0;
+        }
+        madvise(base, tamanho, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    fonte->texto = base;
+    fonte->tamanho = tamanho;
+    fonte->mapeado = total;
+    return 1;
+}
+#endif
+
+int abrirFonte(Fonte *fonte, const char *caminho) {
+    fonte->texto = NULL;
+    fonte->tamanho = 0;
+    fonte->mapeado = 0;
+
+#ifndef _WIN32
+    int mapeada = mapearFonte(fonte, caminho);
+    if (mapeada != 0) {
+        return mapeada;
+    }
+#endif
+    return lerFonte(fonte, caminho);
+}
+
+void fecharFonte(Fonte *fonte) {
+    if (fonte->texto == NULL) {
+        return;
+    }
+
+#ifndef _WIN32
+    if (fonte->mapeado > 0) {
+        munmap(fonte->texto, fonte->mapeado);
+    } else {
+        free(fonte->texto);
+    }
+#else
+    free(fonte->texto);
+#endif
+
+    fonte->texto = NULL;
+    fonte->tamanho = 0;
+    fonte->mapeado = 0;
+}
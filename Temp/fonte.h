@@ -0,0 +1,26 @@
+#ifndef FONTE_H
+#define FONTE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Os tokens guardam deslocamentos de 32 bits no texto */
+#define FONTE_TAMANHO_MAXIMO UINT32_MAX
+
+/*
+ * Texto-fonte em memoria, pronto para o scanner ler no lugar: o conteudo do
+ * arquivo e seguido de dois '\0'. Sempre que possivel o arquivo e mapeado
+ * com mmap, sem copia para buffers intermediarios.
+ */
+typedef struct {
+    char *texto;          /* Conteudo do arquivo + dois '\0' */
+    size_t tamanho;       /* Bytes do arquivo (sem os '\0' finais) */
+    size_t mapeado;       /* Bytes mapeados (0 = texto lido com malloc) */
+} Fonte;
+
+/* 1 = aberto, 0 = erro ao abrir, -1 = maior que FONTE_TAMANHO_MAXIMO */
+int abrirFonte(Fonte *fonte, const char *caminho);
+
+void fecharFonte(Fonte *fonte);
+
+#endif
@@ -1,155 +1,577 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 #include "intermediario.h"
 #include "arvore.h"
+#include "contexto.h"
+#include "paralelo.h"
 
-/* Array para armazenar as instrucoes geradas */
-static Instrucao3Endereco *instrucoes = NULL;
-static int totalInstrucoes = 0;
-static int capacidadeInstrucoes = 100;
+/* Capacidade inicial do vetor de instrucoes */
+#define CAPACIDADE_INICIAL 100
 
-/* Contador de variaveis temporarias */
-static int contadorTemp = 0;
+/* Texto de cada operador, na ordem do enum Operador */
+static const char* const nomesOperador[NUM_OPERADORES] = {
+    "+", "-", "*", "/", "=",
+    "<", ">", "<=", ">=", "==", "!=",
+    "label", "goto", "if_false", "param", "call", "return", "=[]", "[]=",
+    "func", "endfunc", "phi"
+};
+
+/*
+ * Codigo de uma declaracao do topo, gerado independente das outras. Cada
+ * unidade numera os seus temporarios e rotulos a partir de 0; a juncao os
+ * desloca para a sequencia do programa.
+ */
+typedef struct {
+    const Arvore *arvore;
+    const TabelaAtomos *atomos;   /* So leitura (valor dos literais) */
+    NoId no;
+    CodigoIntermediario codigo;
+    Operando *argumentos;         /* Argumentos ja avaliados das chamadas abertas */
+    int totalArgumentos;
+    int capacidadeArgumentos;
+} UnidadeCodigo;
 
 /* Funcoes auxiliares */
-static void gerarInstrucao(const char *op, const char *op1, const char *op2, const char *res);
-static char* gerarTemp(void);
-static void analisarNoIntermediario(NoArvore *no, char *resultado);
+static void gerarInstrucao(CodigoIntermediario *c, Operador op, Operando op1, Operando op2,
+                           Operando res);
+static Operando gerarTemp(CodigoIntermediario *c);
+static void analisarNoIntermediario(UnidadeCodigo *u, Operando *resultado);
+
+const char* nomeOperador(Operador op) {
+    return nomesOperador[op];
+}
+
+static Operando criarOperando(TipoOperando tipo, int valor) {
+    Operando op;
+    op.tipo = tipo;
+    op.valor = valor;
+    return op;
+}
 
 /*
- * gerarTemp - Gera um novo nome de variavel temporaria
+ * operandoVariavel - Uso de um nome: as locais int (e parametros) viram
+ * OPERANDO_LOCAL, que a forma SSA renomeia; globais e arrays ficam na memoria
  */
-static char* gerarTemp(void) {
-    static char temp[20];
-    sprintf(temp, "t%d", contadorTemp++);
-    return temp;
+static Operando operandoVariavel(const Arvore *a, NoId no) {
+    const Simbolo *s = simboloNo(a, no);
+    int local = s != NULL && s->escopo != NULL && s->escopo->nivel > 0 && s->tipo == TIPO_INT;
+    return criarOperando(local ? OPERANDO_LOCAL : OPERANDO_VARIAVEL, (int) valorNo(a, no));
+}
+
+/*
+ * gerarTemp - Gera um novo temporario (numerado dentro da unidade)
+ */
+static Operando gerarTemp(CodigoIntermediario *c) {
+    return criarOperando(OPERANDO_TEMP, c->contadorTemp++);
 }
 
 /*
  * gerarInstrucao - Adiciona uma instrucao a lista
  */
-static void gerarInstrucao(const char *op, const char *op1, const char *op2, const char *res) {
-    if (totalInstrucoes >= capacidadeInstrucoes) {
-        capacidadeInstrucoes *= 2;
-        instrucoes = (Instrucao3Endereco*) realloc(instrucoes, 
-                     sizeof(Instrucao3Endereco) * capacidadeInstrucoes);
+static void gerarInstrucao(CodigoIntermediario *c, Operador op, Operando op1, Operando op2,
+                           Operando res) {
+    if (c->totalInstrucoes >= c->capacidadeInstrucoes) {
+        c->capacidadeInstrucoes = c->capacidadeInstrucoes ? c->capacidadeInstrucoes * 2 : CAPACIDADE_INICIAL;
+        c->instrucoes = (Instrucao3Endereco*) realloc(c->instrucoes, 
+                        sizeof(Instrucao3Endereco) * c->capacidadeInstrucoes);
+        if (c->instrucoes == NULL) {
+            fprintf(stderr, "Erro de alocacao de memoria para o codigo intermediario\n");
+            exit(1);
+        }
     }
     
-    instrucoes[totalInstrucoes].numero = totalInstrucoes + 1;
-    strncpy(instrucoes[totalInstrucoes].operador, op, sizeof(instrucoes[totalInstrucoes].operador) - 1);
-    strncpy(instrucoes[totalInstrucoes].operando1, op1, sizeof(instrucoes[totalInstrucoes].operando1) - 1);
-    strncpy(instrucoes[totalInstrucoes].operando2, op2, sizeof(instrucoes[totalInstrucoes].operando2) - 1);
-    strncpy(instrucoes[totalInstrucoes].resultado, res, sizeof(instrucoes[totalInstrucoes].resultado) - 1);
+    Instrucao3Endereco *inst = &c->instrucoes[c->totalInstrucoes];
+    inst->operador = (unsigned char) op;
+    inst->tipos[OPERANDO1] = (unsigned char) op1.tipo;
+    inst->tipos[OPERANDO2] = (unsigned char) op2.tipo;
+    inst->tipos[RESULTADO] = (unsigned char) res.tipo;
+    inst->valores[OPERANDO1] = op1.valor;
+    inst->valores[OPERANDO2] = op2.valor;
+    inst->valores[RESULTADO] = res.valor;
     
-    totalInstrucoes++;
+    c->totalInstrucoes++;
 }
 
-static void analisarNoIntermediario(NoArvore *no, char *resultado) {
-    if (no == NULL) return;
+/*
+ * Quadro do percurso de geracao. Cada no entrega o seu resultado num dos
+ * dois valores do quadro 'destino' (por indice: a pilha pode mudar de
+ * lugar), ou na pilha de argumentos da unidade se for argumento de uma
+ * chamada. Os nos que so repassam (listas, comandos) usam o destino do
+ * pai. Comandos com varias etapas (if, while, chamada) reempilham o proprio
+ * quadro com a fase seguinte, levando os rotulos ja criados.
+ */
+typedef struct {
+    NoId no;
+    int fase;             /* 0 = ida; as seguintes, depois de cada filho */
+    int irmaos;           /* 1 = o proximo irmao vem depois, com o mesmo destino */
+    size_t destino;       /* Quadro que recebe o resultado */
+    int posicao;          /* Qual dos valores do destino (0, 1 ou POSICAO_ARGUMENTO) */
+    Operando valores[2];  /* Resultados dos operandos deste no */
+    int rotulos[2];       /* Rotulos do if/while entre uma fase e outra */
+    int argumentos;       /* Topo da pilha de argumentos antes da chamada */
+} QuadroCodigo;
+
+/* O resultado vai para a pilha de argumentos da unidade */
+#define POSICAO_ARGUMENTO -1
+
+static void empilharQuadroCodigo(PilhaPercurso *pilha, NoId no, int fase, int irmaos,
+                                 size_t destino, int posicao) {
+    QuadroCodigo *q = (QuadroCodigo*) empilhar(pilha);
+    q->no = no;
+    q->fase = fase;
+    q->irmaos = irmaos;
+    q->destino = destino;
+    q->posicao = posicao;
+    q->valores[0] = criarOperando(OPERANDO_NENHUM, 0);
+    q->valores[1] = criarOperando(OPERANDO_NENHUM, 0);
+    q->rotulos[0] = q->rotulos[1] = 0;
+    q->argumentos = 0;
+}
+
+/* Reempilha o quadro do no para a fase dada (o irmao ja foi empilhado) */
+static void retomarQuadroCodigo(PilhaPercurso *pilha, const QuadroCodigo *q, int fase) {
+    QuadroCodigo *r = (QuadroCodigo*) empilhar(pilha);
+    *r = *q;
+    r->fase = fase;
+    r->irmaos = 0;
+}
+
+static void entregarResultado(UnidadeCodigo *u, PilhaPercurso *pilha, const QuadroCodigo *q,
+                              Operando valor) {
+    if (q->posicao == POSICAO_ARGUMENTO) {
+        if (u->totalArgumentos >= u->capacidadeArgumentos) {
+            u->capacidadeArgumentos = u->capacidadeArgumentos ? u->capacidadeArgumentos * 2 : 16;
+            u->argumentos = (Operando*) realloc(u->argumentos,
+                            sizeof(Operando) * (size_t) u->capacidadeArgumentos);
+            if (u->argumentos == NULL) {
+                fprintf(stderr, "Erro de alocacao de memoria para o codigo intermediario\n");
+                exit(1);
+            }
+        }
+        u->argumentos[u->totalArgumentos++] = valor;
+        return;
+    }
+    QuadroCodigo *destino = (QuadroCodigo*) quadroPilha(pilha, q->destino);
+    destino->valores[q->posicao] = valor;
+}
+
+/* Operador da instrucao para o atomo de um NO_OP */
+static Operador operadorRelacional(Atomo atomo) {
+    switch (atomo) {
+    case ATOMO_MENOR:      return OP_MENOR;
+    case ATOMO_MAIOR:      return OP_MAIOR;
+    case ATOMO_MENORIGUAL: return OP_MENORIGUAL;
+    case ATOMO_MAIORIGUAL: return OP_MAIORIGUAL;
+    case ATOMO_IGUAL:      return OP_IGUAL;
+    default:               return OP_DIFERENTE;
+    }
+}
+
+/*
+ * analisarNoIntermediario - Gera o codigo da subarvore com uma pilha
+ * explicita (sem limite de profundidade); o valor final fica em *resultado
+ */
+static void analisarNoIntermediario(UnidadeCodigo *u, Operando *resultado) {
+    CodigoIntermediario *c = &u->codigo;
+    const Arvore *a = u->arvore;
+    NoId raiz = u->no;
+    PilhaPercurso pilha = PILHA_PERCURSO_INICIAL(QuadroCodigo);
+    const Operando nenhum = criarOperando(OPERANDO_NENHUM, 0);
     
-    char temp1[50], temp2[50];
+    /* O quadro 0 so guarda o resultado da raiz */
+    empilharQuadroCodigo(&pilha, NO_NULO, 0, 0, 0, 0);
+    ((QuadroCodigo*) quadroPilha(&pilha, 0))->valores[0] = *resultado;
+    empilharQuadroCodigo(&pilha, raiz, 0, 0, 0, 0);
     
-    /* EXPRESSOES BINARIAS (SOMA, SUB, MULT, DIV) */
-    if (strcmp(no->tipo, "SOMA") == 0 || strcmp(no->tipo, "SUB") == 0 ||
-        strcmp(no->tipo, "MULT") == 0 || strcmp(no->tipo, "DIV") == 0) {
+    while (pilha.total > 1) {
+        QuadroCodigo q = *(QuadroCodigo*) desempilhar(&pilha);
+        NoId no = q.no;
+        if (no == NO_NULO) continue;
         
-        /* Gera codigo para operando 1 */
-        analisarNoIntermediario(no->filhos[0], temp1);
+        /* Na ida, o irmao seguinte espera a subarvore deste no */
+        if (q.irmaos && q.fase == 0 && proximoIrmao(a, no) != NO_NULO) {
+            empilharQuadroCodigo(&pilha, proximoIrmao(a, no), 0, 1, q.destino, q.posicao);
+        }
         
-        /* Gera codigo para operando 2 */
-        analisarNoIntermediario(no->filhos[1], temp2);
+        size_t proprio = pilha.total;  /* Indice do quadro retomado, se houver */
+        NoId esq = primeiroFilho(a, no);
         
-        /* Gera a instrucao de operacao */
-        char op[5];
-        if (strcmp(no->tipo, "SOMA") == 0) strcpy(op, "+");
-        else if (strcmp(no->tipo, "SUB") == 0) strcpy(op, "-");
-        else if (strcmp(no->tipo, "MULT") == 0) strcpy(op, "*");
-        else strcpy(op, "/");
+        switch (tipoNo(a, no)) {
+        /* EXPRESSOES BINARIAS (SOMA, SUB, MULT, DIV) */
+        case NO_SOMA:
+        case NO_SUB:
+        case NO_MULT:
+        case NO_DIV: {
+            if (q.fase == 0) {
+                /* Operandos 1 e 2 primeiro; a instrucao sai na volta */
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, proximoIrmao(a, esq), 0, 0, proprio, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            }
+            
+            /* Gera a instrucao de operacao */
+            Operador op;
+            switch (tipoNo(a, no)) {
+            case NO_SOMA: op = OP_SOMA; break;
+            case NO_SUB:  op = OP_SUB; break;
+            case NO_MULT: op = OP_MULT; break;
+            default:      op = OP_DIV; break;
+            }
+            
+            Operando temp = gerarTemp(c);
+            gerarInstrucao(c, op, q.valores[0], q.valores[1], temp);
+            entregarResultado(u, &pilha, &q, temp);
+            break;
+        }
         
-        char *temp = gerarTemp();
-        gerarInstrucao(op, temp1, temp2, temp);
-        strcpy(resultado, temp);
-    }
-    
-    /* ATRIBUICAO */
-    else if (strcmp(no->tipo, "ATRIB") == 0) {
-        char tempdireito[50];
+        /* RELACIONAL: esq, NO_OP e dir; o resultado e 0 ou 1 */
+        case NO_REL: {
+            NoId operador = proximoIrmao(a, esq);
+            if (q.fase == 0) {
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, proximoIrmao(a, operador), 0, 0, proprio, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            }
+            
+            Operando temp = gerarTemp(c);
+            gerarInstrucao(c, operadorRelacional(valorNo(a, operador)), q.valores[0], q.valores[1], temp);
+            entregarResultado(u, &pilha, &q, temp);
+            break;
+        }
         
-        /* Processa lado direito */
-        if (no->filhos[1] != NULL) {
-            analisarNoIntermediario(no->filhos[1], tempdireito);
+        /* ATRIBUICAO: a variavel ou um elemento de array */
+        case NO_ATRIB: {
+            NoId dir = proximoIrmao(a, esq);
+            if (q.fase == 0) {
+                /* Indice do lado esquerdo (se houver), depois o lado direito */
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, dir, 0, 0, proprio, 0);
+                if (tipoNo(a, esq) == NO_ID_ARRAY) {
+                    empilharQuadroCodigo(&pilha, primeiroFilho(a, esq), 0, 0, proprio, 1);
+                }
+                break;
+            }
+            
+            Operando variavel = operandoVariavel(a, esq);
+            if (tipoNo(a, esq) == NO_ID_ARRAY) {
+                gerarInstrucao(c, OP_ARMAZENA, q.valores[0], q.valores[1], variavel);
+                entregarResultado(u, &pilha, &q, q.valores[0]);
+            } else {
+                gerarInstrucao(c, OP_ATRIB, q.valores[0], nenhum, variavel);
+                entregarResultado(u, &pilha, &q, variavel);
+            }
+            break;
         }
         
-        /* Atribui ao lado esquerdo */
-        if (no->filhos[0] != NULL && strcmp(no->filhos[0]->tipo, "ID") == 0) {
-            gerarInstrucao("=", tempdireito, "", no->filhos[0]->valor);
-            strcpy(resultado, no->filhos[0]->valor);
+        /* LEITURA DE ELEMENTO DE ARRAY */
+        case NO_ID_ARRAY: {
+            if (q.fase == 0) {
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            }
+            
+            Operando temp = gerarTemp(c);
+            gerarInstrucao(c, OP_CARREGA, criarOperando(OPERANDO_VARIAVEL, (int) valorNo(a, no)),
+                           q.valores[0], temp);
+            entregarResultado(u, &pilha, &q, temp);
+            break;
+        }
+        
+        /* CHAMADA: argumentos na pilha da unidade, depois param e call */
+        case NO_CHAMADA_FUNCAO: {
+            if (q.fase == 0) {
+                q.argumentos = u->totalArgumentos;
+                retomarQuadroCodigo(&pilha, &q, 1);
+                if (esq != NO_NULO && primeiroFilho(a, esq) != NO_NULO) {
+                    empilharQuadroCodigo(&pilha, primeiroFilho(a, esq), 0, 1, proprio,
+                                         POSICAO_ARGUMENTO);
+                }
+                break;
+            }
+            
+            int numArgs = u->totalArgumentos - q.argumentos;
+            for (int i = q.argumentos; i < u->totalArgumentos; i++) {
+                gerarInstrucao(c, OP_PARAM, u->argumentos[i], nenhum, nenhum);
+            }
+            u->totalArgumentos = q.argumentos;
+            
+            /* Funcao void nao tem valor para guardar */
+            const Simbolo *s = simboloNo(a, no);
+            Operando temp = (s != NULL && s->tipo == TIPO_VOID) ? nenhum : gerarTemp(c);
+            gerarInstrucao(c, OP_CHAMADA, criarOperando(OPERANDO_VARIAVEL, (int) valorNo(a, no)),
+                           criarOperando(OPERANDO_IMEDIATO, numArgs), temp);
+            entregarResultado(u, &pilha, &q, temp);
+            break;
+        }
+        
+        /* RETORNO, com ou sem valor */
+        case NO_RETURN:
+            if (q.fase == 0 && esq != NO_NULO) {
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            }
+            gerarInstrucao(c, OP_RETORNO, q.valores[0], nenhum, nenhum);
+            break;
+        
+        /* IF e IF-ELSE: condicao, desvio para o else (ou fim), os ramos */
+        case NO_IF:
+        case NO_IFELSE:
+            switch (q.fase) {
+            case 0:
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            case 1:
+                q.rotulos[0] = c->contadorRotulos++;
+                gerarInstrucao(c, OP_SE_FALSO, q.valores[0], nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[0]));
+                retomarQuadroCodigo(&pilha, &q, 2);
+                empilharQuadroCodigo(&pilha, proximoIrmao(a, esq), 0, 0, q.destino, q.posicao);
+                break;
+            case 2:
+                if (tipoNo(a, no) == NO_IF) {
+                    gerarInstrucao(c, OP_ROTULO, nenhum, nenhum,
+                                   criarOperando(OPERANDO_ROTULO, q.rotulos[0]));
+                    break;
+                }
+                q.rotulos[1] = c->contadorRotulos++;
+                gerarInstrucao(c, OP_DESVIO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[1]));
+                gerarInstrucao(c, OP_ROTULO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[0]));
+                retomarQuadroCodigo(&pilha, &q, 3);
+                empilharQuadroCodigo(&pilha, filhoNo(a, no, 2), 0, 0, q.destino, q.posicao);
+                break;
+            default:
+                gerarInstrucao(c, OP_ROTULO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[1]));
+                break;
+            }
+            break;
+        
+        /* WHILE: rotulo do teste, saida se falso, corpo e volta ao teste */
+        case NO_WHILE:
+            switch (q.fase) {
+            case 0:
+                q.rotulos[0] = c->contadorRotulos++;
+                gerarInstrucao(c, OP_ROTULO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[0]));
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, esq, 0, 0, proprio, 0);
+                break;
+            case 1:
+                q.rotulos[1] = c->contadorRotulos++;
+                gerarInstrucao(c, OP_SE_FALSO, q.valores[0], nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[1]));
+                retomarQuadroCodigo(&pilha, &q, 2);
+                empilharQuadroCodigo(&pilha, proximoIrmao(a, esq), 0, 0, q.destino, q.posicao);
+                break;
+            default:
+                gerarInstrucao(c, OP_DESVIO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[0]));
+                gerarInstrucao(c, OP_ROTULO, nenhum, nenhum,
+                               criarOperando(OPERANDO_ROTULO, q.rotulos[1]));
+                break;
+            }
+            break;
+        
+        /* FUNCAO: marca inicio e fim em volta do corpo */
+        case NO_FUN_DEF: {
+            Operando nome = criarOperando(OPERANDO_VARIAVEL, (int) valorNo(a, no));
+            if (q.fase == 0) {
+                gerarInstrucao(c, OP_FUNCAO, nome, nenhum, nenhum);
+                retomarQuadroCodigo(&pilha, &q, 1);
+                empilharQuadroCodigo(&pilha, filhoNo(a, no, 2), 0, 0, q.destino, q.posicao);
+                break;
+            }
+            gerarInstrucao(c, OP_FIM_FUNCAO, nome, nenhum, nenhum);
+            break;
+        }
+        
+        /* NUMERO */
+        case NO_NUM:
+            entregarResultado(u, &pilha, &q, criarOperando(OPERANDO_IMEDIATO, valorLiteral(a, no)));
+            break;
+        
+        /* IDENTIFICADOR */
+        case NO_ID:
+            entregarResultado(u, &pilha, &q, operandoVariavel(a, no));
+            break;
+        
+        /* DECLARACOES: variaveis nao geram codigo */
+        case NO_VAR:
+        case NO_ARRAY_VAR:
+            break;
+        
+        /* OUTROS NOS - Apenas percorre filhos (com o mesmo destino) */
+        default:
+            if (esq != NO_NULO) {
+                empilharQuadroCodigo(&pilha, esq, 0, 1, q.destino, q.posicao);
+            }
+            break;
         }
     }
     
-    /* NUMERO */
-    else if (strcmp(no->tipo, "NUM") == 0) {
-        strcpy(resultado, no->valor);
-    }
-    
-    /* IDENTIFICADOR */
-    else if (strcmp(no->tipo, "ID") == 0) {
-        strcpy(resultado, no->valor);
-    }
+    *resultado = ((QuadroCodigo*) quadroPilha(&pilha, 0))->valores[0];
+    liberarPilha(&pilha);
+}
+
+/* Tarefa paralela: gera o codigo da i-esima declaracao do topo */
+static void gerarUnidade(void *dados, int i) {
+    UnidadeCodigo *u = &((UnidadeCodigo*) dados)[i];
+    Operando resultado = criarOperando(OPERANDO_NENHUM, 0);
+    analisarNoIntermediario(u, &resultado);
+    free(u->argumentos);
+    u->argumentos = NULL;
+}
+
+/*
+ * juntarUnidade - Copia o codigo de uma unidade para o fim do programa,
+ * deslocando os temporarios e rotulos para a sequencia dos anteriores
+ */
+static void juntarUnidade(ContextoCompilador *ctx, CodigoIntermediario *u) {
+    CodigoIntermediario *c = &ctx->codigo;
+    int base = c->contadorTemp;
+    int baseRotulos = c->contadorRotulos;
     
-    /* OUTROS NOS - Apenas percorre filhos */
-    else {
-        for (int i = 0; i < no->nFilhos; i++) {
-            analisarNoIntermediario(no->filhos[i], resultado);
+    for (int i = 0; i < u->totalInstrucoes; i++) {
+        Instrucao3Endereco *inst = &c->instrucoes[c->totalInstrucoes++];
+        *inst = u->instrucoes[i];
+        for (int k = OPERANDO1; k <= RESULTADO; k++) {
+            if (inst->tipos[k] == OPERANDO_TEMP) {
+                inst->valores[k] += base;
+            } else if (inst->tipos[k] == OPERANDO_ROTULO) {
+                inst->valores[k] += baseRotulos;
+            }
         }
     }
+    c->contadorTemp += u->contadorTemp;
+    c->contadorRotulos += u->contadorRotulos;
+    
+    free(u->instrucoes);
 }
 
-int gerarCodigoIntermediario(NoArvore *raiz) {
-    contadorTemp = 0;
-    totalInstrucoes = 0;
+int gerarCodigoIntermediario(ContextoCompilador *ctx) {
+    CodigoIntermediario *c = &ctx->codigo;
+    c->contadorTemp = 0;
+    c->contadorRotulos = 0;
+    c->totalInstrucoes = 0;
     
-    /* Aloca memoria para instrucoes */
-    instrucoes = (Instrucao3Endereco*) malloc(sizeof(Instrucao3Endereco) * capacidadeInstrucoes);
+    if (ctx->raiz == NO_NULO) {
+        /* Aloca memoria para instrucoes */
+        c->capacidadeInstrucoes = CAPACIDADE_INICIAL;
+        c->instrucoes = (Instrucao3Endereco*) malloc(sizeof(Instrucao3Endereco) * c->capacidadeInstrucoes);
+        return 0;
+    }
     
-    if (raiz == NULL) return 0;
+    /* Cada declaracao do topo gera o seu codigo, em paralelo */
+    int n = 0;
+    NoId *nos = coletarDeclaracoes(&ctx->arvore, ctx->raiz, &n);
+    UnidadeCodigo *unidades = (UnidadeCodigo*) malloc(sizeof(UnidadeCodigo) * (size_t) (n > 0 ? n : 1));
+    if (unidades == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o codigo intermediario\n");
+        exit(1);
+    }
+    CodigoIntermediario vazio = CODIGO_INTERMEDIARIO_INICIAL;
+    for (int i = 0; i < n; i++) {
+        unidades[i].arvore = &ctx->arvore;
+        unidades[i].atomos = &ctx->atomos;
+        unidades[i].no = nos[i];
+        unidades[i].codigo = vazio;
+        unidades[i].argumentos = NULL;
+        unidades[i].totalArgumentos = 0;
+        unidades[i].capacidadeArgumentos = 0;
+    }
+    executarEmParalelo(n, ctx->numThreads, gerarUnidade, unidades);
     
-    char resultado[50];
-    analisarNoIntermediario(raiz, resultado);
+    /* Junta na ordem do fonte, com um unico vetor do tamanho exato */
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        total += unidades[i].codigo.totalInstrucoes;
+    }
+    c->capacidadeInstrucoes = total > CAPACIDADE_INICIAL ? total : CAPACIDADE_INICIAL;
+    c->instrucoes = (Instrucao3Endereco*) malloc(sizeof(Instrucao3Endereco) * c->capacidadeInstrucoes);
+    if (c->instrucoes == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o codigo intermediario\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        juntarUnidade(ctx, &unidades[i].codigo);
+    }
     
-    return totalInstrucoes;
+    free(unidades);
+    free(nos);
+    return c->totalInstrucoes;
 }
 
-void imprimirCodigoIntermediario(void) {
-    printf("\n");
-    printf("================================================================================\n");
-    printf("                        CODIGO INTERMEDIARIO (3-ADDRESS CODE)                   \n");
-    printf("================================================================================\n");
-    printf("%-8s %-10s %-15s %-15s %-15s\n", 
-           "Num", "Op", "Operando1", "Operando2", "Resultado");
-    printf("--------------------------------------------------------------------------------\n");
+/* Operando como campo de largura 'largura' (t3, 42, nome, L2 ou vazio) */
+static void imprimirOperando(Saida *saida, const TabelaAtomos *atomos, Operando op, int largura) {
+    switch (op.tipo) {
+    case OPERANDO_TEMP:
+        saidaCaractere(saida, 't');
+        saidaCampoInteiro(saida, op.valor, largura - 1);
+        break;
+    case OPERANDO_IMEDIATO:
+        saidaCampoInteiro(saida, op.valor, largura);
+        break;
+    case OPERANDO_VARIAVEL:
+    case OPERANDO_LOCAL:
+        saidaCampo(saida, nomeAtomo(atomos, (Atomo) op.valor), largura);
+        break;
+    case OPERANDO_ROTULO:
+        saidaCaractere(saida, 'L');
+        saidaCampoInteiro(saida, op.valor, largura - 1);
+        break;
+    default:
+        saidaEspacos(saida, (size_t) largura);
+        break;
+    }
+}
+
+void imprimirCodigoIntermediario(ContextoCompilador *ctx, Saida *saida) {
+    const CodigoIntermediario *c = &ctx->codigo;
+    const TabelaAtomos *atomos = &ctx->atomos;
+
+    saidaTexto(saida, "\n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "                        CODIGO INTERMEDIARIO (3-ADDRESS CODE)                   \n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "Num      Op         Operando1       Operando2       Resultado      \n");
+    saidaTexto(saida, "--------------------------------------------------------------------------------\n");
     
-    for (int i = 0; i < totalInstrucoes; i++) {
-        printf("%-8d %-10s %-15s %-15s %-15s\n",
-               instrucoes[i].numero,
-               instrucoes[i].operador,
-               instrucoes[i].operando1,
-               instrucoes[i].operando2,
-               instrucoes[i].resultado);
+    /* Campos alinhados como "%-8d %-10s %-15s %-15s %-15s" */
+    for (int i = 0; i < c->totalInstrucoes; i++) {
+        const Instrucao3Endereco *inst = &c->instrucoes[i];
+        saidaCampoInteiro(saida, i + 1, 8);
+        saidaCaractere(saida, ' ');
+        saidaCampo(saida, nomeOperador((Operador) inst->operador), 10);
+        saidaCaractere(saida, ' ');
+        imprimirOperando(saida, atomos, operandoInstrucao(inst, OPERANDO1), 15);
+        saidaCaractere(saida, ' ');
+        imprimirOperando(saida, atomos, operandoInstrucao(inst, OPERANDO2), 15);
+        saidaCaractere(saida, ' ');
+        imprimirOperando(saida, atomos, operandoInstrucao(inst, RESULTADO), 15);
+        saidaCaractere(saida, '\n');
     }
     
-    printf("================================================================================\n");
+    saidaTexto(saida, "================================================================================\n");
 }
 
 /*
  * liberarCodigoIntermediario - Libera memoria alocada
  */
-void liberarCodigoIntermediario(void) {
-    if (instrucoes != NULL) {
-        free(instrucoes);
-        instrucoes = NULL;
+void liberarCodigoIntermediario(ContextoCompilador *ctx) {
+    CodigoIntermediario *c = &ctx->codigo;
+    if (c->instrucoes != NULL) {
+        free(c->instrucoes);
+        c->instrucoes = NULL;
     }
-    totalInstrucoes = 0;
-    contadorTemp = 0;
+    c->totalInstrucoes = 0;
+    c->capacidadeInstrucoes = 0;
+    c->contadorTemp = 0;
+    c->contadorRotulos = 0;
 }
@@ -1,19 +1,98 @@
 #ifndef INTERMEDIARIO_H
 #define INTERMEDIARIO_H
 #include "arvore.h"
+#include "atomos.h"
+#include "saida.h"
 
+/* Operacoes do codigo de tres enderecos */
+typedef enum {
+    OP_SOMA,                 /* resultado = operando1 + operando2 */
+    OP_SUB,
+    OP_MULT,
+    OP_DIV,
+    OP_ATRIB,                /* resultado = operando1 */
+    OP_MENOR,                /* resultado = operando1 < operando2 (0 ou 1) */
+    OP_MAIOR,
+    OP_MENORIGUAL,
+    OP_MAIORIGUAL,
+    OP_IGUAL,
+    OP_DIFERENTE,
+    OP_ROTULO,               /* resultado: rotulo que marca este ponto */
+    OP_DESVIO,               /* goto resultado */
+    OP_SE_FALSO,             /* if_false operando1 goto resultado */
+    OP_PARAM,                /* Empilha operando1 para a proxima chamada */
+    OP_CHAMADA,              /* resultado = operando1(operando2 parametros) */
+    OP_RETORNO,              /* return operando1 (ou sem valor) */
+    OP_CARREGA,              /* resultado = operando1[operando2] */
+    OP_ARMAZENA,             /* resultado[operando2] = operando1 */
+    OP_FUNCAO,               /* Inicio da funcao operando1 */
+    OP_FIM_FUNCAO,           /* Fim da funcao operando1 */
+    OP_PHI,                  /* So na forma SSA: resultado = phi(argumentos); operando1 e
+                                o primeiro argumento no vetor da funcao, operando2 quantos */
+    NUM_OPERADORES
+} Operador;
+
+/* O que um operando guarda em 'valor' */
+typedef enum {
+    OPERANDO_NENHUM,         /* Ausente */
+    OPERANDO_TEMP,           /* Numero do temporario (t0, t1, ...) */
+    OPERANDO_IMEDIATO,       /* Constante inteira de 32 bits */
+    OPERANDO_VARIAVEL,       /* Atomo da global, array ou funcao (memoria) */
+    OPERANDO_LOCAL,          /* Atomo da local ou parametro int (renomeado na SSA) */
+    OPERANDO_ROTULO,         /* Numero do rotulo (L0, L1, ...) */
+    OPERANDO_VALOR           /* So na forma SSA: indice do valor na funcao */
+} TipoOperando;
+
+typedef struct {
+    TipoOperando tipo;
+    int valor;
+} Operando;
+
+/* Posicoes dos operandos numa instrucao */
+enum {
+    OPERANDO1,
+    OPERANDO2,
+    RESULTADO
+};
+
+/*
+ * Instrucao em 16 bytes: operador e etiquetas dos operandos num byte cada,
+ * e os tres valores (temporario, imediato, atomo ou rotulo) em 32 bits. O numero
+ * da instrucao e a posicao dela no vetor.
+ */
 typedef struct {
-    int numero;              /* Numero sequencial da instrucao */
-    char operador[10];       /* Operador: +, -, *, /, =, <, >, etc */
-    char operando1[50];      /* Primeiro operando */
-    char operando2[50];      /* Segundo operando (opcional) */
-    char resultado[50];      /* Variavel resultado/temporaria */
+    unsigned char operador;  /* Operador */
+    unsigned char tipos[3];  /* TipoOperando de cada posicao */
+    int valores[3];          /* Operando1, operando2 e resultado */
 } Instrucao3Endereco;
 
-int gerarCodigoIntermediario(NoArvore *raiz);
+static inline Operando operandoInstrucao(const Instrucao3Endereco *inst, int posicao) {
+    Operando op;
+    op.tipo = (TipoOperando) inst->tipos[posicao];
+    op.valor = inst->valores[posicao];
+    return op;
+}
+
+/* Codigo gerado por uma compilacao (guardado no contexto) */
+typedef struct {
+    Instrucao3Endereco *instrucoes;  /* Instrucoes na ordem de geracao */
+    int totalInstrucoes;
+    int capacidadeInstrucoes;
+    int contadorTemp;                /* Proximo temporario (t0, t1, ...) */
+    int contadorRotulos;             /* Proximo rotulo (L0, L1, ...) */
+} CodigoIntermediario;
+
+/* Codigo vazio, pronto para uso */
+#define CODIGO_INTERMEDIARIO_INICIAL { NULL, 0, 0, 0, 0 }
+
+struct ContextoCompilador;
+
+const char* nomeOperador(Operador op);
+
+int gerarCodigoIntermediario(struct ContextoCompilador *ctx);
 
-void imprimirCodigoIntermediario(void);
+void imprimirCodigoIntermediario(struct ContextoCompilador *ctx, Saida *saida);
 
-void liberarCodigoIntermediario(void);
+void liberarCodigoIntermediario(struct ContextoCompilador *ctx);
 
 #endif
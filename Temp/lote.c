@@ -0,0 +1,355 @@
+/* sysconf mesmo com -std=c99 */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "lote.h"
+#include "paralelo.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/*
+ * Fila de trabalho de uma thread: guarda indices de arquivos no intervalo
+ * [inicio, fim). A dona tira do inicio (arquivos mais antigos primeiro, o que
+ * ajuda a escrita em ordem); quem rouba tira do fim, longe da dona.
+ */
+typedef struct {
+    pthread_mutex_t trava;
+    int *tarefas;
+    int inicio;
+    int fim;
+} FilaTrabalho;
+
+/* Saida de um arquivo, guardada ate chegar a sua vez de ser escrita */
+typedef struct {
+    char *texto;
+    size_t tamanho;
+    size_t bytesFonte;
+    int falhou;
+    int pronto;
+} ResultadoArquivo;
+
+typedef struct {
+    const OpcoesCompilacao *op;
+    const ListaArquivos *lista;
+    FilaTrabalho *filas;
+    int numFilas;
+    ResultadoArquivo *resultados;
+    pthread_mutex_t trava;        /* Protege 'pronto' dos resultados */
+    pthread_cond_t concluido;     /* Sinalizado a cada arquivo terminado */
+} Lote;
+
+typedef struct {
+    Lote *lote;
+    int id;
+} Trabalhador;
+
+static void* alocarOuSair(size_t tamanho) {
+    void *p = malloc(tamanho);
+    if (p == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o lote\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void adicionarCaminho(ListaArquivos *lista, const char *caminho) {
+    if (lista->total == lista->capacidade) {
+        lista->capacidade = lista->capacidade ? lista->capacidade * 2 : 64;
+        lista->caminhos = (char**) realloc(lista->caminhos, sizeof(char*) * lista->capacidade);
+        if (lista->caminhos == NULL) {
+            fprintf(stderr, "Erro de alocacao de memoria para o lote\n");
+            exit(1);
+        }
+    }
+    size_t n = strlen(caminho);
+    char *copia = (char*) alocarOuSair(n + 1);
+    memcpy(copia, caminho, n + 1);
+    lista->caminhos[lista->total++] = copia;
+}
+
+static int compararNomes(const void *a, const void *b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+static int terminaEmCm(const char *nome) {
+    size_t n = strlen(nome);
+    return n > 3 && strcmp(nome + n - 3, ".cm") == 0;
+}
+
+/*
+ * adicionarDiretorio - Acrescenta os .cm do diretorio em ordem alfabetica,
+ * para que a ordem da saida nao dependa do sistema de arquivos
+ */
+static int adicionarDiretorio(ListaArquivos *lista, const char *diretorio) {
+    DIR *dir = opendir(diretorio);
+    if (dir == NULL) {
+        return 0;
+    }
+
+    int primeiro = lista->total;
+    size_t tamDir = strlen(diretorio);
+    struct dirent *entrada;
+    while ((entrada = readdir(dir)) != NULL) {
+        if (!terminaEmCm(entrada->d_name)) {
+            continue;
+        }
+        size_t tamNome = strlen(entrada->d_name);
+        char *caminho = (char*) alocarOuSair(tamDir + tamNome + 2);
+        memcpy(caminho, diretorio, tamDir);
+        caminho[tamDir] = '/';
+        memcpy(caminho + tamDir + 1, entrada->d_name, tamNome + 1);
+        adicionarCaminho(lista, caminho);
+        free(caminho);
+    }
+    closedir(dir);
+
+    qsort(lista->caminhos + primeiro, (size_t) (lista->total - primeiro),
+          sizeof(char*), compararNomes);
+    return 1;
+}
+
+static int adicionarLista(ListaArquivos *lista, const char *arquivo) {
+    FILE *fp = fopen(arquivo, "r");
+    if (fp == NULL) {
+        return 0;
+    }
+
+    char linha[4096];
+    while (fgets(linha, sizeof(linha), fp) != NULL) {
+        size_t n = strcspn(linha, "\r\n");
+        linha[n] = '\0';
+        if (n > 0) {
+            adicionarCaminho(lista, linha);
+        }
+    }
+    fclose(fp);
+    return 1;
+}
+
+int adicionarEntrada(ListaArquivos *lista, const char *entrada, int ehLista) {
+    if (ehLista) {
+        return adicionarLista(lista, entrada);
+    }
+
+    struct stat info;
+    if (stat(entrada, &info) == 0 && S_ISDIR(info.st_mode)) {
+        return adicionarDiretorio(lista, entrada);
+    }
+
+    /* Arquivos inexistentes entram mesmo assim e falham com mensagem propria */
+    adicionarCaminho(lista, entrada);
+    return 1;
+}
+
+void liberarListaArquivos(ListaArquivos *lista) {
+    for (int i = 0; i < lista->total; i++) {
+        free(lista->caminhos[i]);
+    }
+    free(lista->caminhos);
+    lista->caminhos = NULL;
+    lista->total = 0;
+    lista->capacidade = 0;
+}
+
+int numeroDeNucleos(void) {
+#ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) {
+        return (int) n;
+    }
+#endif
+    return 1;
+}
+
+static double agora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * pegarTarefa - Tira o proximo arquivo da propria fila ou, se ela estiver
+ * vazia, rouba do fim da fila de outra thread (-1 quando acabou tudo)
+ */
+static int pegarTarefa(Lote *lote, int id) {
+    FilaTrabalho *propria = &lote->filas[id];
+    int tarefa = -1;
+
+    pthread_mutex_lock(&propria->trava);
+    if (propria->inicio < propria->fim) {
+        tarefa = propria->tarefas[propria->inicio++];
+    }
+    pthread_mutex_unlock(&propria->trava);
+    if (tarefa >= 0) {
+        return tarefa;
+    }
+
+    /* Nenhuma tarefa nova e criada durante o lote: se todas as filas
+       estiverem vazias, o trabalho acabou */
+    for (int k = 1; k < lote->numFilas && tarefa < 0; k++) {
+        FilaTrabalho *vitima = &lote->filas[(id + k) % lote->numFilas];
+        pthread_mutex_lock(&vitima->trava);
+        if (vitima->inicio < vitima->fim) {
+            tarefa = vitima->tarefas[--vitima->fim];
+        }
+        pthread_mutex_unlock(&vitima->trava);
+    }
+    return tarefa;
+}
+
+/*
+ * compilarParaMemoria - Compila um arquivo com toda a saida num buffer
+ */
+static void compilarParaMemoria(const OpcoesCompilacao *op, const char *arquivo,
+                                ResultadoArquivo *r) {
+    SaidaMemoria memoria;
+    FILE *fp = abrirSaidaMemoria(&memoria);
+    if (fp == NULL) {
+        fprintf(stderr, "Erro ao criar a saida em memoria para %s\n", arquivo);
+        r->falhou = 1;
+        return;
+    }
+
+    fprintf(fp, "##### %s #####\n", arquivo);
+    r->falhou = compilarArquivo(op, arquivo, fp, fp, fp, &r->bytesFonte) != 0;
+    fprintf(fp, "\n");
+
+    fecharSaidaMemoria(&memoria);
+    r->texto = memoria.texto;
+    r->tamanho = memoria.tamanho;
+}
+
+static void* executarTrabalhador(void *arg) {
+    Trabalhador *t = (Trabalhador*) arg;
+    Lote *lote = t->lote;
+    int tarefa;
+
+    while ((tarefa = pegarTarefa(lote, t->id)) >= 0) {
+        ResultadoArquivo *r = &lote->resultados[tarefa];
+        compilarParaMemoria(lote->op, lote->lista->caminhos[tarefa], r);
+
+        pthread_mutex_lock(&lote->trava);
+        r->pronto = 1;
+        pthread_cond_broadcast(&lote->concluido);
+        pthread_mutex_unlock(&lote->trava);
+    }
+    return NULL;
+}
+
+int compilarLote(const OpcoesCompilacao *op, const ListaArquivos *lista,
+                 int numThreads, FILE *destino) {
+    int n = lista->total;
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+    if (numThreads > n && n > 0) {
+        numThreads = n;
+    }
+
+    /* A escrita em segundo plano nao ajuda aqui: todas as threads ja compilam */
+    OpcoesCompilacao opLote = *op;
+    opLote.saidaAssincrona = 0;
+    /* Os arquivos ja ocupam os nucleos: cada um roda as fases em serie */
+    opLote.numThreads = 1;
+
+    Lote lote;
+    lote.op = &opLote;
+    lote.lista = lista;
+    lote.numFilas = numThreads;
+    lote.filas = (FilaTrabalho*) alocarOuSair(sizeof(FilaTrabalho) * numThreads);
+    lote.resultados = (ResultadoArquivo*) calloc((size_t) (n > 0 ? n : 1), sizeof(ResultadoArquivo));
+    if (lote.resultados == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para o lote\n");
+        exit(1);
+    }
+    pthread_mutex_init(&lote.trava, NULL);
+    pthread_cond_init(&lote.concluido, NULL);
+
+    /* Distribuicao inicial alternada: cada fila comeca pelos primeiros arquivos */
+    for (int t = 0; t < numThreads; t++) {
+        FilaTrabalho *fila = &lote.filas[t];
+        pthread_mutex_init(&fila->trava, NULL);
+        fila->tarefas = (int*) alocarOuSair(sizeof(int) * (size_t) (n / numThreads + 1));
+        fila->inicio = 0;
+        fila->fim = 0;
+        for (int i = t; i < n; i += numThreads) {
+            fila->tarefas[fila->fim++] = i;
+        }
+    }
+
+    double inicio = agora();
+
+    Trabalhador *trabalhadores = (Trabalhador*) alocarOuSair(sizeof(Trabalhador) * numThreads);
+    pthread_t *threads = (pthread_t*) alocarOuSair(sizeof(pthread_t) * numThreads);
+    int criadas = 0;
+    for (int t = 0; t < numThreads; t++) {
+        trabalhadores[t].lote = &lote;
+        trabalhadores[t].id = t;
+        if (pthread_create(&threads[t], NULL, executarTrabalhador, &trabalhadores[t]) != 0) {
+            break;
+        }
+        criadas++;
+    }
+    if (criadas == 0) {
+        /* Sem threads, a propria chamadora esvazia todas as filas */
+        executarTrabalhador(&trabalhadores[0]);
+    }
+
+    /* Escreve cada arquivo assim que ele e todos os anteriores terminaram */
+    size_t bytesFonte = 0;
+    int falhas = 0;
+    for (int i = 0; i < n; i++) {
+        ResultadoArquivo *r = &lote.resultados[i];
+        pthread_mutex_lock(&lote.trava);
+        while (!r->pronto) {
+            pthread_cond_wait(&lote.concluido, &lote.trava);
+        }
+        pthread_mutex_unlock(&lote.trava);
+
+        if (r->texto != NULL) {
+            fwrite(r->texto, 1, r->tamanho, destino);
+            free(r->texto);
+            r->texto = NULL;
+        }
+        bytesFonte += r->bytesFonte;
+        falhas += r->falhou;
+    }
+
+    for (int t = 0; t < criadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double segundos = agora() - inicio;
+    if (segundos <= 0) {
+        segundos = 1e-9;
+    }
+
+    fprintf(destino, "==========================================================================\n");
+    fprintf(destino, "                           RESUMO DO LOTE\n");
+    fprintf(destino, "==========================================================================\n");
+    fprintf(destino, "Arquivos: %d (%d nao puderam ser lidos)\n", n, falhas);
+    fprintf(destino, "Threads: %d\n", criadas > 0 ? criadas : 1);
+    fprintf(destino, "Fonte: %zu bytes\n", bytesFonte);
+    fprintf(destino, "Tempo: %.3f s\n", segundos);
+    fprintf(destino, "Vazao: %.1f arquivos/s, %.2f MB/s\n",
+            n / segundos, bytesFonte / (1024.0 * 1024.0) / segundos);
+
+    for (int t = 0; t < numThreads; t++) {
+        pthread_mutex_destroy(&lote.filas[t].trava);
+        free(lote.filas[t].tarefas);
+    }
+    pthread_cond_destroy(&lote.concluido);
+    pthread_mutex_destroy(&lote.trava);
+    free(threads);
+    free(trabalhadores);
+    free(lote.filas);
+    free(lote.resultados);
+    return falhas;
+}
@@ -0,0 +1,37 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdio.h>
+#include "compilador.h"
+
+/* Lista de caminhos de fontes a compilar */
+typedef struct {
+    char **caminhos;
+    int total;
+    int capacidade;
+} ListaArquivos;
+
+#define LISTA_ARQUIVOS_INICIAL { NULL, 0, 0 }
+
+/*
+ * adicionarEntrada - Acrescenta um fonte, todos os .cm de um diretorio (em
+ * ordem alfabetica) ou, com 'ehLista', cada linha de um arquivo de lista.
+ * Devolve 0 se a entrada nao pode ser lida.
+ */
+int adicionarEntrada(ListaArquivos *lista, const char *entrada, int ehLista);
+
+void liberarListaArquivos(ListaArquivos *lista);
+
+/* Numero de nucleos disponiveis (padrao de --jobs) */
+int numeroDeNucleos(void);
+
+/*
+ * compilarLote - Compila todos os arquivos com 'numThreads' threads. Cada
+ * arquivo tem a sua saida (mensagens, erros e artefatos) guardada em memoria
+ * e escrita em 'destino' na ordem da lista, seguida de um resumo de vazao.
+ * Devolve o numero de arquivos que nao puderam ser lidos.
+ */
+int compilarLote(const OpcoesCompilacao *op, const ListaArquivos *lista,
+                 int numThreads, FILE *destino);
+
+#endif
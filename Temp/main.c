@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compilador.h"
+#include "lote.h"
+
+/* Definido em cminus.y */
+extern int yydebug;
+
+typedef struct {
+    OpcoesCompilacao compilacao;
+    const char *saida;        /* Arquivo de saida dos artefatos (NULL = stdout) */
+    int lote;                 /* --batch: varios arquivos e diretorios */
+    int numThreads;           /* --jobs (0 = uma por nucleo) */
+    ListaArquivos arquivos;   /* Fontes na ordem da linha de comando */
+} Opcoes;
+
+static void imprimirUso(const char *programa) {
+    printf("Uso: %s [opcoes] <arquivo.cm>\n", programa);
+    printf("     %s --batch [opcoes] <arquivo.cm|diretorio>...\n", programa);
+    printf("  --stop-after=parse|sema|ir   ultima fase executada (padrao: ir)\n");
+    printf("  --emit=LISTA                 artefatos separados por virgula:\n");
+    printf("                               tokens,ast,ir,cfg,ssa,symbols,stats (padrao: todos)\n");
+    printf("  --tokens=tabela|fluxo|nenhum como gravar os tokens (padrao: tabela)\n");
+    printf("  --ast=compacta|detalhada     arvore sem ou com os nos DECL e CMD (padrao: compacta)\n");
+    printf("  -O0|-O1                      sem ou com propagacao de constantes (padrao: -O1)\n");
+    printf("  -o ARQUIVO                   grava os artefatos em ARQUIVO\n");
+    printf("  --async-output               escreve os artefatos numa thread separada\n");
+    printf("  --batch                      compila varios arquivos (diretorios: todos os .cm)\n");
+    printf("  --lista=ARQUIVO              compila os caminhos listados, um por linha (implica --batch)\n");
+    printf("  -j N, --jobs=N               threads do lote, ou das fases por funcao de um\n");
+    printf("                               arquivo so (padrao: uma por nucleo)\n");
+}
+
+/*
+ * lerEmitir - Converte a lista de --emit numa mascara (-1 se invalida)
+ */
+static int lerEmitir(const char *lista) {
+    int mascara = 0;
+    const char *p = lista;
+
+    while (*p != '\0') {
+        size_t n = strcspn(p, ",");
+        if (n == 6 && strncmp(p, "tokens", n) == 0) mascara |= EMITIR_TOKENS;
+        else if (n == 3 && strncmp(p, "ast", n) == 0) mascara |= EMITIR_AST;
+        else if (n == 2 && strncmp(p, "ir", n) == 0) mascara |= EMITIR_IR;
+        else if (n == 7 && strncmp(p, "symbols", n) == 0) mascara |= EMITIR_SIMBOLOS;
+        else if (n == 5 && strncmp(p, "stats", n) == 0) mascara |= EMITIR_STATS;
+        else if (n == 3 && strncmp(p, "cfg", n) == 0) mascara |= EMITIR_FLUXO;
+        else if (n == 3 && strncmp(p, "ssa", n) == 0) mascara |= EMITIR_SSA;
+        else if (n == 4 && strncmp(p, "none", n) == 0) mascara |= 0;
+        else return -1;
+
+        p += n;
+        if (*p == ',') p++;
+    }
+    return mascara;
+}
+
+/*
+ * lerOpcoes - Interpreta a linha de comando (0 se o uso for invalido)
+ */
+static int lerOpcoes(int argc, char *argv[], Opcoes *op) {
+    OpcoesCompilacao *c = &op->compilacao;
+    c->ultimaFase = PARAR_APOS_IR;
+    c->emitir = EMITIR_TUDO;
+    c->modoTokens = TOKENS_TABELA;
+    c->astDetalhada = 0;
+    c->saidaAssincrona = 0;
+    c->numThreads = 1;
+    c->otimizar = 1;
+    op->saida = NULL;
+    op->lote = 0;
+    op->numThreads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+
+        if (strcmp(arg, "--stop-after=parse") == 0) {
+            c->ultimaFase = PARAR_APOS_PARSE;
+        } else if (strcmp(arg, "--stop-after=sema") == 0) {
+            c->ultimaFase = PARAR_APOS_SEMA;
+        } else if (strcmp(arg, "--stop-after=ir") == 0) {
+            c->ultimaFase = PARAR_APOS_IR;
+        } else if (strncmp(arg, "--emit=", 7) == 0) {
+            c->emitir = lerEmitir(arg + 7);
+            if (c->emitir < 0) {
+                return 0;
+            }
+        } else if (strcmp(arg, "--tokens=tabela") == 0) {
+            c->modoTokens = TOKENS_TABELA;
+        } else if (strcmp(arg, "--tokens=fluxo") == 0) {
+            c->modoTokens = TOKENS_FLUXO;
+        } else if (strcmp(arg, "--tokens=nenhum") == 0) {
+            c->modoTokens = TOKENS_NENHUM;
+        } else if (strcmp(arg, "--ast=compacta") == 0) {
+            c->astDetalhada = 0;
+        } else if (strcmp(arg, "--ast=detalhada") == 0) {
+            c->astDetalhada = 1;
+        } else if (strcmp(arg, "--async-output") == 0) {
+            c->saidaAssincrona = 1;
+        } else if (strcmp(arg, "-O0") == 0) {
+            c->otimizar = 0;
+        } else if (strcmp(arg, "-O1") == 0) {
+            c->otimizar = 1;
+        } else if (strcmp(arg, "-o") == 0 && i + 1 < argc) {
+            op->saida = argv[++i];
+        } else if (strcmp(arg, "--batch") == 0) {
+            op->lote = 1;
+        } else if (strncmp(arg, "--lista=", 8) == 0) {
+            op->lote = 1;
+            if (!adicionarEntrada(&op->arquivos, arg + 8, 1)) {
+                printf("Erro ao abrir a lista %s\n", arg + 8);
+                return 0;
+            }
+        } else if (strncmp(arg, "--jobs=", 7) == 0 || strncmp(arg, "-j", 2) == 0) {
+            const char *valor = arg + 7;
+            if (arg[1] == 'j') {
+                /* -jN ou -j N */
+                valor = arg[2] != '\0' ? arg + 2 : (i + 1 < argc ? argv[++i] : "");
+            }
+            op->numThreads = atoi(valor);
+            if (op->numThreads < 1) {
+                return 0;
+            }
+        } else if (arg[0] != '-') {
+            if (!adicionarEntrada(&op->arquivos, arg, 0)) {
+                printf("Erro ao abrir diretorio %s\n", arg);
+                return 0;
+            }
+        } else {
+            return 0;
+        }
+    }
+
+    /* Tokens so sao gravados se forem pedidos */
+    if (!(c->emitir & EMITIR_TOKENS)) {
+        c->modoTokens = TOKENS_NENHUM;
+    }
+    if (op->lote) {
+        return op->arquivos.total > 0;
+    }
+    return op->arquivos.total == 1;
+}
+
+int main(int argc, char *argv[]) {
+    Opcoes op;
+    op.arquivos = (ListaArquivos) LISTA_ARQUIVOS_INICIAL;
+    if (!lerOpcoes(argc, argv, &op)) {
+        imprimirUso(argv[0]);
+        liberarListaArquivos(&op.arquivos);
+        return 1;
+    }
+
+    /* Desliga debug para saida limpa */
+    yydebug = 0;
+
+    FILE *arquivoSaida = stdout;
+    if (op.saida != NULL) {
+        arquivoSaida = fopen(op.saida, "w");
+        if (!arquivoSaida) {
+            printf("Erro ao criar arquivo %s\n", op.saida);
+            liberarListaArquivos(&op.arquivos);
+            return 1;
+        }
+    }
+
+    int status;
+    int numThreads = op.numThreads > 0 ? op.numThreads : numeroDeNucleos();
+    if (op.lote) {
+        /* Cada arquivo e compilado por inteiro numa thread do lote */
+        status = compilarLote(&op.compilacao, &op.arquivos, numThreads, arquivoSaida) != 0;
+    } else {
+        /* Um arquivo so: as funcoes dele e que sao divididas entre as threads */
+        op.compilacao.numThreads = numThreads;
+        size_t bytesFonte;
+        status = compilarArquivo(&op.compilacao, op.arquivos.caminhos[0], stdout, stderr,
+                                 arquivoSaida, &bytesFonte) != 0;
+    }
+
+    if (arquivoSaida != stdout) {
+        fclose(arquivoSaida);
+    }
+    liberarListaArquivos(&op.arquivos);
+    return status;
+}
@@ -0,0 +1,99 @@
+/* open_memstream mesmo com -std=c99 */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "paralelo.h"
+
+typedef struct {
+    TarefaParalela tarefa;
+    void *dados;
+    int total;
+    int proximo;                  /* Proximo indice a entregar */
+    pthread_mutex_t trava;        /* Protege 'proximo' */
+} Distribuicao;
+
+static void* executarParte(void *arg) {
+    Distribuicao *d = (Distribuicao*) arg;
+
+    for (;;) {
+        pthread_mutex_lock(&d->trava);
+        int i = d->proximo++;
+        pthread_mutex_unlock(&d->trava);
+
+        if (i >= d->total) {
+            break;
+        }
+        d->tarefa(d->dados, i);
+    }
+    return NULL;
+}
+
+void executarEmParalelo(int total, int numThreads, TarefaParalela tarefa, void *dados) {
+    if (numThreads > total) {
+        numThreads = total;
+    }
+    if (numThreads <= 1) {
+        for (int i = 0; i < total; i++) {
+            tarefa(dados, i);
+        }
+        return;
+    }
+
+    Distribuicao d;
+    d.tarefa = tarefa;
+    d.dados = dados;
+    d.total = total;
+    d.proximo = 0;
+    pthread_mutex_init(&d.trava, NULL);
+
+    /* A chamadora tambem trabalha: cria so numThreads - 1 threads */
+    pthread_t *threads = (pthread_t*) malloc(sizeof(pthread_t) * (size_t) (numThreads - 1));
+    int criadas = 0;
+    if (threads != NULL) {
+        while (criadas < numThreads - 1 &&
+               pthread_create(&threads[criadas], NULL, executarParte, &d) == 0) {
+            criadas++;
+        }
+    }
+
+    executarParte(&d);
+
+    for (int t = 0; t < criadas; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+    pthread_mutex_destroy(&d.trava);
+}
+
+FILE* abrirSaidaMemoria(SaidaMemoria *m) {
+    m->texto = NULL;
+    m->tamanho = 0;
+#ifndef _WIN32
+    m->arquivo = open_memstream(&m->texto, &m->tamanho);
+#else
+    m->arquivo = tmpfile();
+#endif
+    return m->arquivo;
+}
+
+void fecharSaidaMemoria(SaidaMemoria *m) {
+    if (m->arquivo == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    /* tmpfile nao expoe o conteudo: copia para um buffer proprio */
+    long tamanho = ftell(m->arquivo);
+    m->tamanho = tamanho > 0 ? (size_t) tamanho : 0;
+    m->texto = (char*) malloc(m->tamanho + 1);
+    if (m->texto != NULL) {
+        rewind(m->arquivo);
+        m->tamanho = fread(m->texto, 1, m->tamanho, m->arquivo);
+    } else {
+        m->tamanho = 0;
+    }
+#endif
+    fclose(m->arquivo);
+    m->arquivo = NULL;
+}
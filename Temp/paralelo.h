@@ -0,0 +1,35 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Trabalho independente de indice 'i' (nao pode depender de outro indice) */
+typedef void (*TarefaParalela)(void *dados, int i);
+
+/*
+ * executarEmParalelo - Chama tarefa(dados, i) para todo i em [0, total) com
+ * ate 'numThreads' threads; cada thread pega o proximo indice livre ao
+ * terminar o anterior. Com uma thread (ou um indice) roda na chamadora.
+ */
+void executarEmParalelo(int total, int numThreads, TarefaParalela tarefa, void *dados);
+
+/*
+ * Texto acumulado em memoria por uma tarefa, para ser escrito depois na
+ * ordem certa. 'arquivo' so existe entre abrir e fechar.
+ */
+typedef struct {
+    FILE *arquivo;
+    char *texto;
+    size_t tamanho;
+} SaidaMemoria;
+
+#define SAIDA_MEMORIA_INICIAL { NULL, NULL, 0 }
+
+/* Devolve NULL se nao foi possivel criar o arquivo em memoria */
+FILE* abrirSaidaMemoria(SaidaMemoria *m);
+
+/* Fecha o arquivo; o texto fica em m->texto/m->tamanho (liberar com free) */
+void fecharSaidaMemoria(SaidaMemoria *m);
+
+#endif
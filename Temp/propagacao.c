@@ -0,0 +1,547 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "propagacao.h"
+#include "contexto.h"
+#include "paralelo.h"
+
+/* Reticulado de cada valor: ainda sem informacao, constante ou variavel */
+enum {
+    INDEFINIDO,
+    CONSTANTE,
+    VARIAVEL
+};
+
+static int* alocarInteiros(int n, int valor) {
+    int *v = (int*) malloc(sizeof(int) * (size_t) (n > 0 ? n : 1));
+    if (v == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a propagacao de constantes\n");
+        exit(1);
+    }
+    for (int i = 0; i < n; i++) {
+        v[i] = valor;
+    }
+    return v;
+}
+
+/* Estado da propagacao numa funcao (liberado no fim) */
+typedef struct {
+    FuncaoSSA *f;
+    int *estado;              /* INDEFINIDO, CONSTANTE ou VARIAVEL, por valor */
+    int *constante;           /* Valor de cada CONSTANTE */
+    int *blocoInstrucao;      /* Bloco de cada instrucao (-1 = func/endfunc) */
+    int *primeiroUso;         /* Instrucoes que usam cada valor, num vetor so */
+    int *usos;
+    int *blocoExecutavel;
+    int *arestaExecutavel;    /* Pela posicao em f->predecessores */
+    int *destinoAresta;
+    int *arestasPendentes;    /* Pilhas de trabalho */
+    int totalArestasPendentes;
+    int *valoresPendentes;
+    int totalValoresPendentes;
+    int capacidadeValoresPendentes;
+} Propagacao;
+
+static void marcarAresta(Propagacao *p, int origem, int destino) {
+    const FuncaoSSA *f = p->f;
+    int e = f->blocos[destino].primeiroPredecessor;
+    while (f->predecessores[e] != origem) {
+        e++;
+    }
+    if (p->arestaExecutavel[e]) return;
+    p->arestaExecutavel[e] = 1;
+    p->arestasPendentes[p->totalArestasPendentes++] = e;
+}
+
+/* Rebaixa o valor no reticulado (so desce) e agenda os seus usos */
+static void rebaixar(Propagacao *p, int v, int estado, int constante) {
+    if (estado == INDEFINIDO || p->estado[v] == VARIAVEL) return;
+    if (p->estado[v] == CONSTANTE && (estado == CONSTANTE && p->constante[v] == constante)) return;
+    if (p->estado[v] == CONSTANTE) estado = VARIAVEL;
+
+    p->estado[v] = estado;
+    p->constante[v] = constante;
+    if (p->totalValoresPendentes >= p->capacidadeValoresPendentes) {
+        p->capacidadeValoresPendentes = p->capacidadeValoresPendentes ? p->capacidadeValoresPendentes * 2 : 64;
+        p->valoresPendentes = (int*) realloc(p->valoresPendentes,
+                              sizeof(int) * (size_t) p->capacidadeValoresPendentes);
+        if (p->valoresPendentes == NULL) {
+            fprintf(stderr, "Erro de alocacao de memoria para a propagacao de constantes\n");
+            exit(1);
+        }
+    }
+    p->valoresPendentes[p->totalValoresPendentes++] = v;
+}
+
+/* Estado de um operando: numero e constante, global ou array e variavel */
+static int estadoOperando(const Propagacao *p, int tipo, int valor, int *constante) {
+    if (tipo == OPERANDO_IMEDIATO) {
+        *constante = valor;
+        return CONSTANTE;
+    }
+    if (tipo == OPERANDO_VALOR) {
+        *constante = p->constante[valor];
+        return p->estado[valor];
+    }
+    return VARIAVEL;
+}
+
+/*
+ * calcular - Resultado de uma operacao entre constantes, com a aritmetica
+ * de 32 bits com volta do parser; divisao por zero nao e dobrada
+ */
+static int calcular(Operador op, int a, int b, int *resultado) {
+    unsigned int x = (unsigned int) a, y = (unsigned int) b;
+    switch (op) {
+    case OP_SOMA:        *resultado = (int) (x + y); return 1;
+    case OP_SUB:         *resultado = (int) (x - y); return 1;
+    case OP_MULT:        *resultado = (int) (x * y); return 1;
+    case OP_DIV:
+        if (b == 0) return 0;
+        *resultado = b == -1 ? (int) (0u - x) : a / b;
+        return 1;
+    case OP_MENOR:       *resultado = a < b; return 1;
+    case OP_MAIOR:       *resultado = a > b; return 1;
+    case OP_MENORIGUAL:  *resultado = a <= b; return 1;
+    case OP_MAIORIGUAL:  *resultado = a >= b; return 1;
+    case OP_IGUAL:       *resultado = a == b; return 1;
+    case OP_DIFERENTE:   *resultado = a != b; return 1;
+    default:             return 0;
+    }
+}
+
+/* Operadores cujo resultado so depende dos operandos */
+static int ehCalculo(Operador op) {
+    return op <= OP_DIV || (op >= OP_MENOR && op <= OP_DIFERENTE);
+}
+
+/*
+ * avaliar - Reavalia a instrucao i de um bloco executavel: o valor que ela
+ * define ou, se for desvio, as arestas que podem ser tomadas
+ */
+static void avaliar(Propagacao *p, int i) {
+    const FuncaoSSA *f = p->f;
+    const Instrucao3Endereco *inst = &f->instrucoes[i];
+    Operador op = (Operador) inst->operador;
+    int b = p->blocoInstrucao[i];
+    int c1 = 0, c2 = 0;
+
+    if (op == OP_PHI) {
+        /* Encontro dos argumentos que chegam por arestas executaveis */
+        int estado = INDEFINIDO, constante = 0;
+        int primeira = f->blocos[b].primeiroPredecessor;
+        for (int k = 0; k < inst->valores[OPERANDO2] && estado != VARIAVEL; k++) {
+            if (!p->arestaExecutavel[primeira + k]) continue;
+            Operando arg = f->argumentosPhi[inst->valores[OPERANDO1] + k];
+            int c;
+            int e = estadoOperando(p, arg.tipo, arg.valor, &c);
+            if (e == INDEFINIDO) continue;
+            if (e == VARIAVEL || (estado == CONSTANTE && c != constante)) {
+                estado = VARIAVEL;
+            } else {
+                estado = CONSTANTE;
+                constante = c;
+            }
+        }
+        rebaixar(p, inst->valores[RESULTADO], estado, constante);
+        return;
+    }
+
+    if (op == OP_SE_FALSO) {
+        const BlocoBasico *bloco = &f->blocos[b];
+        int e = estadoOperando(p, inst->tipos[OPERANDO1], inst->valores[OPERANDO1], &c1);
+        if (e == INDEFINIDO) return;
+        if (e == VARIAVEL || bloco->numSucessores == 1) {
+            for (int k = 0; k < bloco->numSucessores; k++) {
+                marcarAresta(p, b, bloco->sucessores[k]);
+            }
+        } else {
+            /* sucessores[0] segue (verdadeiro), sucessores[1] e o rotulo */
+            marcarAresta(p, b, bloco->sucessores[c1 == 0 ? 1 : 0]);
+        }
+        return;
+    }
+    if (op == OP_DESVIO) {
+        marcarAresta(p, b, f->blocos[b].sucessores[0]);
+        return;
+    }
+    if (inst->tipos[RESULTADO] != OPERANDO_VALOR) return;
+
+    int resultado = inst->valores[RESULTADO];
+    if (op == OP_ATRIB) {
+        int e = estadoOperando(p, inst->tipos[OPERANDO1], inst->valores[OPERANDO1], &c1);
+        rebaixar(p, resultado, e, c1);
+    } else if (ehCalculo(op)) {
+        int e1 = estadoOperando(p, inst->tipos[OPERANDO1], inst->valores[OPERANDO1], &c1);
+        int e2 = estadoOperando(p, inst->tipos[OPERANDO2], inst->valores[OPERANDO2], &c2);
+        int r;
+        if (e1 == VARIAVEL || e2 == VARIAVEL) {
+            rebaixar(p, resultado, VARIAVEL, 0);
+        } else if (e1 == CONSTANTE && e2 == CONSTANTE) {
+            if (calcular(op, c1, c2, &r)) {
+                rebaixar(p, resultado, CONSTANTE, r);
+            } else {
+                rebaixar(p, resultado, VARIAVEL, 0);
+            }
+        }
+    } else {
+        /* Leitura de array e chamada: nada se sabe do resultado */
+        rebaixar(p, resultado, VARIAVEL, 0);
+    }
+}
+
+/* Ultima instrucao do bloco, se ela desvia (senao -1) */
+static int desvioDoBloco(const FuncaoSSA *f, int b) {
+    const BlocoBasico *bloco = &f->blocos[b];
+    if (bloco->fim == bloco->inicio) return -1;
+    Operador op = (Operador) f->instrucoes[bloco->fim - 1].operador;
+    return (op == OP_DESVIO || op == OP_SE_FALSO || op == OP_RETORNO) ? bloco->fim - 1 : -1;
+}
+
+/*
+ * propagar - Ate as duas pilhas esvaziarem: cada aresta nova torna o
+ * destino executavel (ou reavalia os seus phis) e cada valor rebaixado
+ * reavalia os usos que estao em blocos executaveis
+ */
+static void propagar(Propagacao *p) {
+    const FuncaoSSA *f = p->f;
+
+    /* A entrada e executavel: e visitada antes de qualquer aresta */
+    int pendenteEntrada = f->numBlocos > 0;
+
+    while (pendenteEntrada || p->totalArestasPendentes > 0 || p->totalValoresPendentes > 0) {
+        if (pendenteEntrada || p->totalArestasPendentes > 0) {
+            int s;
+            if (pendenteEntrada) {
+                s = 0;
+                pendenteEntrada = 0;
+            } else {
+                s = p->destinoAresta[p->arestasPendentes[--p->totalArestasPendentes]];
+            }
+            const BlocoBasico *bloco = &f->blocos[s];
+
+            if (p->blocoExecutavel[s]) {
+                /* Ja visitado: so os phis dependem da aresta nova */
+                for (int i = bloco->inicio; i < bloco->fim; i++) {
+                    Operador op = (Operador) f->instrucoes[i].operador;
+                    if (op == OP_PHI) avaliar(p, i);
+                    else if (op != OP_ROTULO) break;
+                }
+                continue;
+            }
+
+            p->blocoExecutavel[s] = 1;
+            for (int i = bloco->inicio; i < bloco->fim; i++) {
+                avaliar(p, i);
+            }
+            if (desvioDoBloco(f, s) < 0) {
+                for (int k = 0; k < bloco->numSucessores; k++) {
+                    marcarAresta(p, s, bloco->sucessores[k]);
+                }
+            }
+            continue;
+        }
+
+        int v = p->valoresPendentes[--p->totalValoresPendentes];
+        for (int u = p->primeiroUso[v]; u < p->primeiroUso[v + 1]; u++) {
+            int i = p->usos[u];
+            if (p->blocoExecutavel[p->blocoInstrucao[i]]) {
+                avaliar(p, i);
+            }
+        }
+    }
+}
+
+/* Valor constante cuja definicao pode sair do codigo */
+static int constanteRemovivel(const Propagacao *p, const int *manter, int v) {
+    return p->estado[v] == CONSTANTE && !manter[v];
+}
+
+/*
+ * marcarMantidos - Uma constante que chega como argumento a um phi que
+ * fica continua definida no codigo: ao sair da SSA o phi vira a propria
+ * local, que precisa ter recebido o valor. Phis mantidos assim propagam a
+ * exigencia aos seus argumentos.
+ */
+static void marcarMantidos(const Propagacao *p, int *manter) {
+    const FuncaoSSA *f = p->f;
+    int *pilha = alocarInteiros(f->totalInstrucoes, 0);
+    int topo = 0;
+
+    for (int b = 0; b < f->numBlocos; b++) {
+        if (!p->blocoExecutavel[b]) continue;
+        for (int i = f->blocos[b].inicio; i < f->blocos[b].fim; i++) {
+            const Instrucao3Endereco *inst = &f->instrucoes[i];
+            if ((Operador) inst->operador == OP_PHI && p->estado[inst->valores[RESULTADO]] != CONSTANTE) {
+                pilha[topo++] = i;
+            }
+        }
+    }
+
+    while (topo > 0) {
+        int i = pilha[--topo];
+        const Instrucao3Endereco *phi = &f->instrucoes[i];
+        int primeira = f->blocos[p->blocoInstrucao[i]].primeiroPredecessor;
+        for (int k = 0; k < phi->valores[OPERANDO2]; k++) {
+            Operando arg = f->argumentosPhi[phi->valores[OPERANDO1] + k];
+            if (!p->arestaExecutavel[primeira + k] || arg.tipo != OPERANDO_VALOR) continue;
+            if (p->estado[arg.valor] != CONSTANTE || manter[arg.valor]) continue;
+            manter[arg.valor] = 1;
+            int definicao = f->valores[arg.valor].definicao;
+            if (definicao >= 0 && (Operador) f->instrucoes[definicao].operador == OP_PHI) {
+                pilha[topo++] = definicao;
+            }
+        }
+    }
+    free(pilha);
+}
+
+/*
+ * reescrever - Aplica o resultado: usos constantes viram numeros, as
+ * definicoes constantes sem uso, os if_false decididos, os blocos nao
+ * executaveis e os rotulos sem desvio somem. Devolve quantas sairam.
+ */
+static int reescrever(Propagacao *p) {
+    FuncaoSSA *f = p->f;
+    int *manter = alocarInteiros(f->totalValores, 0);
+    int *remover = alocarInteiros(f->totalInstrucoes, 0);
+    marcarMantidos(p, manter);
+
+    for (int b = 0; b < f->numBlocos; b++) {
+        const BlocoBasico *bloco = &f->blocos[b];
+        if (!p->blocoExecutavel[b]) f->blocoFluxo[b] = -1;
+        for (int i = bloco->inicio; i < bloco->fim; i++) {
+            Instrucao3Endereco *inst = &f->instrucoes[i];
+            Operador op = (Operador) inst->operador;
+            if (!p->blocoExecutavel[b]) {
+                remover[i] = 1;
+                continue;
+            }
+
+            if (op == OP_PHI) {
+                if (constanteRemovivel(p, manter, inst->valores[RESULTADO])) {
+                    remover[i] = 1;
+                    f->numPhis--;
+                    continue;
+                }
+                /* Argumentos de arestas mortas nao geram copias */
+                for (int k = 0; k < inst->valores[OPERANDO2]; k++) {
+                    if (!p->arestaExecutavel[bloco->primeiroPredecessor + k]) {
+                        f->argumentosPhi[inst->valores[OPERANDO1] + k].tipo = OPERANDO_NENHUM;
+                    }
+                }
+                continue;
+            }
+
+            for (int pos = OPERANDO1; pos <= OPERANDO2; pos++) {
+                if (inst->tipos[pos] == OPERANDO_VALOR && p->estado[inst->valores[pos]] == CONSTANTE) {
+                    inst->valores[pos] = p->constante[inst->valores[pos]];
+                    inst->tipos[pos] = (unsigned char) OPERANDO_IMEDIATO;
+                }
+            }
+
+            if (op == OP_SE_FALSO && inst->tipos[OPERANDO1] == OPERANDO_IMEDIATO) {
+                if (inst->valores[OPERANDO1] != 0) {
+                    remover[i] = 1;
+                } else {
+                    inst->operador = (unsigned char) OP_DESVIO;
+                    inst->tipos[OPERANDO1] = (unsigned char) OPERANDO_NENHUM;
+                    inst->valores[OPERANDO1] = 0;
+                }
+                continue;
+            }
+
+            if (inst->tipos[RESULTADO] == OPERANDO_VALOR && (op == OP_ATRIB || ehCalculo(op)) &&
+                p->estado[inst->valores[RESULTADO]] == CONSTANTE) {
+                int v = inst->valores[RESULTADO];
+                if (!manter[v]) {
+                    remover[i] = 1;
+                } else {
+                    inst->operador = (unsigned char) OP_ATRIB;
+                    inst->tipos[OPERANDO1] = (unsigned char) OPERANDO_IMEDIATO;
+                    inst->valores[OPERANDO1] = p->constante[v];
+                    inst->tipos[OPERANDO2] = (unsigned char) OPERANDO_NENHUM;
+                    inst->valores[OPERANDO2] = 0;
+                }
+            }
+        }
+    }
+
+    /* goto para o bloco seguinte, se os do meio nao sao executaveis (o
+       if_false decidido costuma deixar um): o bloco passa a seguir direto,
+       com as copias dos phis no fim como antes. O destino e o ultimo
+       sucessor: num if_false virado goto, o primeiro ainda e o que segue. */
+    for (int b = 0; b < f->numBlocos; b++) {
+        const BlocoBasico *bloco = &f->blocos[b];
+        int ultima = bloco->fim - 1;
+        if (!p->blocoExecutavel[b] || ultima < bloco->inicio || remover[ultima] ||
+            (Operador) f->instrucoes[ultima].operador != OP_DESVIO) continue;
+        int s = bloco->sucessores[bloco->numSucessores - 1];
+        int meio = b + 1;
+        while (meio < s && !p->blocoExecutavel[meio]) {
+            meio++;
+        }
+        if (meio == s) remover[ultima] = 1;
+    }
+
+    /* Rotulos que nenhum desvio restante usa (a faixa da funcao e contigua) */
+    int menor = 0, maior = -1;
+    for (int i = 0; i < f->totalInstrucoes; i++) {
+        if (f->instrucoes[i].tipos[RESULTADO] != OPERANDO_ROTULO) continue;
+        int r = f->instrucoes[i].valores[RESULTADO];
+        if (maior < menor) menor = maior = r;
+        if (r < menor) menor = r;
+        if (r > maior) maior = r;
+    }
+    int *referencias = alocarInteiros(maior - menor + 1, 0);
+    for (int i = 0; i < f->totalInstrucoes; i++) {
+        Operador op = (Operador) f->instrucoes[i].operador;
+        if (!remover[i] && (op == OP_DESVIO || op == OP_SE_FALSO)) {
+            referencias[f->instrucoes[i].valores[RESULTADO] - menor]++;
+        }
+    }
+    for (int i = 0; i < f->totalInstrucoes; i++) {
+        if ((Operador) f->instrucoes[i].operador == OP_ROTULO &&
+            referencias[f->instrucoes[i].valores[RESULTADO] - menor] == 0) {
+            remover[i] = 1;
+        }
+    }
+
+    /* Compacta as instrucoes; 'novo' leva cada posicao antiga a nova */
+    int *novo = alocarInteiros(f->totalInstrucoes + 1, 0);
+    int destino = 0;
+    for (int i = 0; i < f->totalInstrucoes; i++) {
+        novo[i] = destino;
+        if (remover[i]) continue;
+        f->instrucoes[destino] = f->instrucoes[i];
+        if (f->instrucoes[destino].tipos[RESULTADO] == OPERANDO_VALOR) {
+            f->valores[f->instrucoes[destino].valores[RESULTADO]].definicao = destino;
+        }
+        destino++;
+    }
+    novo[f->totalInstrucoes] = destino;
+    for (int b = 0; b < f->numBlocos; b++) {
+        f->blocos[b].inicio = novo[f->blocos[b].inicio];
+        f->blocos[b].fim = novo[f->blocos[b].fim];
+    }
+    int removidas = f->totalInstrucoes - destino;
+    f->totalInstrucoes = destino;
+
+    free(manter);
+    free(remover);
+    free(referencias);
+    free(novo);
+    return removidas;
+}
+
+/* Dados compartilhados pelas tarefas: a forma SSA e o total de cada funcao */
+typedef struct {
+    FormaSSA *ssa;
+    int *removidas;
+} TarefaPropagacao;
+
+/* Tarefa paralela: propaga na k-esima funcao */
+static void propagarFuncao(void *dados, int k) {
+    TarefaPropagacao *t = (TarefaPropagacao*) dados;
+    FuncaoSSA *f = &t->ssa->funcoes[k];
+    Propagacao p;
+    p.f = f;
+
+    /* Valores da entrada (parametros, locais nao inicializadas) variam */
+    p.estado = alocarInteiros(f->totalValores, INDEFINIDO);
+    p.constante = alocarInteiros(f->totalValores, 0);
+    for (int v = 0; v < f->totalValores; v++) {
+        if (f->valores[v].definicao < 0) p.estado[v] = VARIAVEL;
+    }
+
+    /* Bloco de cada instrucao e usos de cada valor (phis incluidos) */
+    p.blocoInstrucao = alocarInteiros(f->totalInstrucoes, -1);
+    p.primeiroUso = alocarInteiros(f->totalValores + 1, 0);
+    for (int b = 0; b < f->numBlocos; b++) {
+        for (int i = f->blocos[b].inicio; i < f->blocos[b].fim; i++) {
+            const Instrucao3Endereco *inst = &f->instrucoes[i];
+            p.blocoInstrucao[i] = b;
+            if ((Operador) inst->operador == OP_PHI) {
+                for (int k = 0; k < inst->valores[OPERANDO2]; k++) {
+                    Operando arg = f->argumentosPhi[inst->valores[OPERANDO1] + k];
+                    if (arg.tipo == OPERANDO_VALOR) p.primeiroUso[arg.valor + 1]++;
+                }
+                continue;
+            }
+            for (int pos = OPERANDO1; pos <= OPERANDO2; pos++) {
+                if (inst->tipos[pos] == OPERANDO_VALOR) p.primeiroUso[inst->valores[pos] + 1]++;
+            }
+        }
+    }
+    for (int v = 0; v < f->totalValores; v++) {
+        p.primeiroUso[v + 1] += p.primeiroUso[v];
+    }
+    p.usos = alocarInteiros(p.primeiroUso[f->totalValores], 0);
+    int *preenchidos = alocarInteiros(f->totalValores, 0);
+    for (int b = 0; b < f->numBlocos; b++) {
+        for (int i = f->blocos[b].inicio; i < f->blocos[b].fim; i++) {
+            const Instrucao3Endereco *inst = &f->instrucoes[i];
+            if ((Operador) inst->operador == OP_PHI) {
+                for (int k = 0; k < inst->valores[OPERANDO2]; k++) {
+                    Operando arg = f->argumentosPhi[inst->valores[OPERANDO1] + k];
+                    if (arg.tipo == OPERANDO_VALOR) {
+                        p.usos[p.primeiroUso[arg.valor] + preenchidos[arg.valor]++] = i;
+                    }
+                }
+                continue;
+            }
+            for (int pos = OPERANDO1; pos <= OPERANDO2; pos++) {
+                if (inst->tipos[pos] == OPERANDO_VALOR) {
+                    int v = inst->valores[pos];
+                    p.usos[p.primeiroUso[v] + preenchidos[v]++] = i;
+                }
+            }
+        }
+    }
+    free(preenchidos);
+
+    int arestas = 0;
+    for (int b = 0; b < f->numBlocos; b++) {
+        arestas += f->blocos[b].numPredecessores;
+    }
+    p.blocoExecutavel = alocarInteiros(f->numBlocos, 0);
+    p.arestaExecutavel = alocarInteiros(arestas, 0);
+    p.destinoAresta = alocarInteiros(arestas, 0);
+    for (int b = 0; b < f->numBlocos; b++) {
+        for (int k = 0; k < f->blocos[b].numPredecessores; k++) {
+            p.destinoAresta[f->blocos[b].primeiroPredecessor + k] = b;
+        }
+    }
+    p.arestasPendentes = alocarInteiros(arestas, 0);
+    p.totalArestasPendentes = 0;
+    p.valoresPendentes = NULL;
+    p.totalValoresPendentes = 0;
+    p.capacidadeValoresPendentes = 0;
+
+    propagar(&p);
+    t->removidas[k] = reescrever(&p);
+
+    free(p.estado);
+    free(p.constante);
+    free(p.blocoInstrucao);
+    free(p.primeiroUso);
+    free(p.usos);
+    free(p.blocoExecutavel);
+    free(p.arestaExecutavel);
+    free(p.destinoAresta);
+    free(p.arestasPendentes);
+    free(p.valoresPendentes);
+}
+
+int propagarConstantes(ContextoCompilador *ctx) {
+    FormaSSA *ssa = &ctx->ssa;
+    int *removidas = alocarInteiros(ssa->totalFuncoes, 0);
+    TarefaPropagacao tarefa = { ssa, removidas };
+    executarEmParalelo(ssa->totalFuncoes, ctx->numThreads, propagarFuncao, &tarefa);
+
+    int total = 0;
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        total += removidas[k];
+    }
+    free(removidas);
+    return total;
+}
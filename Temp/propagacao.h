@@ -0,0 +1,16 @@
+#ifndef PROPAGACAO_H
+#define PROPAGACAO_H
+
+struct ContextoCompilador;
+
+/*
+ * propagarConstantes - Propagacao esparsa condicional de constantes
+ * (Wegman e Zadeck) sobre a forma SSA do contexto, uma funcao por tarefa.
+ * So segue as arestas que podem ser executadas, troca os usos de valores
+ * constantes pelo numero, apaga as definicoes que ficam sem uso, decide os
+ * if_false de condicao constante e remove os blocos nunca alcancados.
+ * Devolve quantas instrucoes foram removidas.
+ */
+int propagarConstantes(struct ContextoCompilador *ctx);
+
+#endif
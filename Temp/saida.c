@@ -0,0 +1,280 @@
+/* fileno/write mesmo com -std=c99 */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include "saida.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/*
+ * Thread de escrita do modo assincrono. Usa dois buffers: enquanto um esta
+ * pendente (sendo escrito pela thread), o outro recebe o texto novo.
+ */
+typedef struct EscritorSaida {
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t sinal;
+    FILE *destino;
+    char *outro;                  /* Buffer livre para a proxima troca */
+    char *pendente;               /* Buffer entregue a thread (NULL = ocioso) */
+    size_t tamPendente;
+    int encerrar;
+} EscritorSaida;
+
+static char* novoBuffer(void) {
+    char *buffer = (char*) malloc(SAIDA_TAM_BUFFER);
+    if (buffer == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a saida\n");
+        exit(1);
+    }
+    return buffer;
+}
+
+/*
+ * enviar - Grava um bloco no destino. O que ja estiver no buffer do stdio
+ * (printf feitos por fora) e descarregado antes, para manter a ordem.
+ */
+static void enviar(FILE *destino, const char *dados, size_t n) {
+    fflush(destino);
+#ifndef _WIN32
+    int fd = fileno(destino);
+    /* Destinos sem descritor (saida em memoria do modo lote) usam o stdio */
+    if (fd < 0) {
+        if (fwrite(dados, 1, n, destino) != n) {
+            fprintf(stderr, "Erro ao escrever a saida\n");
+        }
+        return;
+    }
+    while (n > 0) {
+        ssize_t escritos = write(fd, dados, n);
+        if (escritos < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "Erro ao escrever a saida\n");
+            return;
+        }
+        dados += escritos;
+        n -= (size_t) escritos;
+    }
+#else
+    if (fwrite(dados, 1, n, destino) != n) {
+        fprintf(stderr, "Erro ao escrever a saida\n");
+    }
+#endif
+}
+
+static void* executarEscritor(void *arg) {
+    EscritorSaida *escritor = (EscritorSaida*) arg;
+
+    pthread_mutex_lock(&escritor->trava);
+    for (;;) {
+        while (escritor->pendente == NULL && !escritor->encerrar) {
+            pthread_cond_wait(&escritor->sinal, &escritor->trava);
+        }
+        if (escritor->pendente == NULL) {
+            break;
+        }
+
+        /* Escreve sem segurar a trava: o outro buffer continua sendo preenchido */
+        char *dados = escritor->pendente;
+        size_t n = escritor->tamPendente;
+        pthread_mutex_unlock(&escritor->trava);
+        enviar(escritor->destino, dados, n);
+        pthread_mutex_lock(&escritor->trava);
+
+        escritor->pendente = NULL;
+        pthread_cond_broadcast(&escritor->sinal);
+    }
+    pthread_mutex_unlock(&escritor->trava);
+    return NULL;
+}
+
+/* Espera a thread terminar o buffer pendente (trava ja adquirida) */
+static void esperarEscritor(EscritorSaida *escritor) {
+    while (escritor->pendente != NULL) {
+        pthread_cond_wait(&escritor->sinal, &escritor->trava);
+    }
+}
+
+void saidaAbrir(Saida *saida, FILE *destino, int assincrona) {
+    saida->destino = destino;
+    saida->buffer = novoBuffer();
+    saida->usado = 0;
+    saida->escritor = NULL;
+
+    if (!assincrona) {
+        return;
+    }
+
+    EscritorSaida *escritor = (EscritorSaida*) malloc(sizeof(EscritorSaida));
+    if (escritor == NULL) {
+        return;
+    }
+    pthread_mutex_init(&escritor->trava, NULL);
+    pthread_cond_init(&escritor->sinal, NULL);
+    escritor->destino = destino;
+    escritor->outro = novoBuffer();
+    escritor->pendente = NULL;
+    escritor->tamPendente = 0;
+    escritor->encerrar = 0;
+
+    if (pthread_create(&escritor->thread, NULL, executarEscritor, escritor) != 0) {
+        /* Sem thread, segue no modo sincrono */
+        free(escritor->outro);
+        pthread_cond_destroy(&escritor->sinal);
+        pthread_mutex_destroy(&escritor->trava);
+        free(escritor);
+        return;
+    }
+    saida->escritor = escritor;
+}
+
+void saidaEsvaziar(Saida *saida) {
+    if (saida->usado == 0) {
+        return;
+    }
+
+    EscritorSaida *escritor = saida->escritor;
+    if (escritor == NULL) {
+        enviar(saida->destino, saida->buffer, saida->usado);
+        saida->usado = 0;
+        return;
+    }
+
+    /* Troca de buffers: o cheio vai para a thread, o livre volta a ser preenchido */
+    pthread_mutex_lock(&escritor->trava);
+    esperarEscritor(escritor);
+    char *cheio = saida->buffer;
+    saida->buffer = escritor->outro;
+    escritor->outro = cheio;
+    escritor->pendente = cheio;
+    escritor->tamPendente = saida->usado;
+    pthread_cond_broadcast(&escritor->sinal);
+    pthread_mutex_unlock(&escritor->trava);
+
+    saida->usado = 0;
+}
+
+void saidaDescarregar(Saida *saida) {
+    saidaEsvaziar(saida);
+
+    EscritorSaida *escritor = saida->escritor;
+    if (escritor != NULL) {
+        pthread_mutex_lock(&escritor->trava);
+        esperarEscritor(escritor);
+        pthread_mutex_unlock(&escritor->trava);
+    }
+}
+
+void saidaFechar(Saida *saida) {
+    saidaDescarregar(saida);
+
+    EscritorSaida *escritor = saida->escritor;
+    if (escritor != NULL) {
+        pthread_mutex_lock(&escritor->trava);
+        escritor->encerrar = 1;
+        pthread_cond_broadcast(&escritor->sinal);
+        pthread_mutex_unlock(&escritor->trava);
+        pthread_join(escritor->thread, NULL);
+
+        free(escritor->outro);
+        pthread_cond_destroy(&escritor->sinal);
+        pthread_mutex_destroy(&escritor->trava);
+        free(escritor);
+        saida->escritor = NULL;
+    }
+
+    free(saida->buffer);
+    saida->buffer = NULL;
+    saida->usado = 0;
+}
+
+/*
+ * saidaEscreverLongo - Copia um texto maior que o espaco livre, esvaziando
+ * o buffer quantas vezes forem necessarias
+ */
+void saidaEscreverLongo(Saida *saida, const char *texto, size_t n) {
+    while (n > 0) {
+        size_t livre = SAIDA_TAM_BUFFER - saida->usado;
+        if (livre == 0) {
+            saidaEsvaziar(saida);
+            continue;
+        }
+        size_t parte = n < livre ? n : livre;
+        memcpy(saida->buffer + saida->usado, texto, parte);
+        saida->usado += parte;
+        texto += parte;
+        n -= parte;
+    }
+}
+
+void saidaEspacos(Saida *saida, size_t n) {
+    while (n > 0) {
+        size_t livre = SAIDA_TAM_BUFFER - saida->usado;
+        if (livre == 0) {
+            saidaEsvaziar(saida);
+            continue;
+        }
+        size_t parte = n < livre ? n : livre;
+        memset(saida->buffer + saida->usado, ' ', parte);
+        saida->usado += parte;
+        n -= parte;
+    }
+}
+
+/*
+ * formatarInteiro - Escreve os digitos de 'valor' terminando em 'fim' e
+ * devolve o inicio do texto
+ */
+static char* formatarInteiro(char *fim, long long valor) {
+    unsigned long long v = valor < 0 ? 0ULL - (unsigned long long) valor
+                                     : (unsigned long long) valor;
+    char *p = fim;
+    do {
+        *--p = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    if (valor < 0) {
+        *--p = '-';
+    }
+    return p;
+}
+
+void saidaInteiro(Saida *saida, long long valor) {
+    char digitos[24];
+    char *fim = digitos + sizeof(digitos);
+    char *inicio = formatarInteiro(fim, valor);
+    saidaEscrever(saida, inicio, (size_t) (fim - inicio));
+}
+
+int saidaLarguraInteiro(long long valor) {
+    char digitos[24];
+    char *fim = digitos + sizeof(digitos);
+    return (int) (fim - formatarInteiro(fim, valor));
+}
+
+void saidaCampoN(Saida *saida, const char *texto, size_t n, int largura) {
+    saidaEscrever(saida, texto, n);
+    if (largura > 0 && (size_t) largura > n) {
+        saidaEspacos(saida, (size_t) largura - n);
+    }
+}
+
+void saidaCampo(Saida *saida, const char *texto, int largura) {
+    saidaCampoN(saida, texto, strlen(texto), largura);
+}
+
+void saidaCampoInteiro(Saida *saida, long long valor, int largura) {
+    char digitos[24];
+    char *fim = digitos + sizeof(digitos);
+    char *inicio = formatarInteiro(fim, valor);
+    saidaCampoN(saida, inicio, (size_t) (fim - inicio), largura);
+}
@@ -0,0 +1,71 @@
+#ifndef SAIDA_H
+#define SAIDA_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Tamanho de cada buffer de escrita */
+#define SAIDA_TAM_BUFFER (1 << 20)
+
+/*
+ * Escritor de relatorios: acumula o texto em buffers grandes e so chama o
+ * sistema quando um deles enche. Os campos com largura fixa sao formatados
+ * a mao, sem passar pelo printf. No modo assincrono uma thread escreve o
+ * buffer cheio enquanto o outro continua sendo preenchido.
+ */
+typedef struct Saida {
+    FILE *destino;                /* Arquivo de destino */
+    char *buffer;                 /* Buffer sendo preenchido */
+    size_t usado;                 /* Bytes ocupados em buffer */
+    struct EscritorSaida *escritor;  /* Thread de escrita (NULL = sincrona) */
+} Saida;
+
+void saidaAbrir(Saida *saida, FILE *destino, int assincrona);
+
+/* Entrega ao destino tudo o que esta pendente (inclusive na thread) */
+void saidaDescarregar(Saida *saida);
+
+void saidaFechar(Saida *saida);
+
+/* Entrega o buffer atual ao destino (ou a thread) e recomeca vazio */
+void saidaEsvaziar(Saida *saida);
+
+void saidaEscreverLongo(Saida *saida, const char *texto, size_t n);
+
+static inline void saidaEscrever(Saida *saida, const char *texto, size_t n) {
+    if (SAIDA_TAM_BUFFER - saida->usado < n) {
+        saidaEscreverLongo(saida, texto, n);
+        return;
+    }
+    memcpy(saida->buffer + saida->usado, texto, n);
+    saida->usado += n;
+}
+
+static inline void saidaTexto(Saida *saida, const char *texto) {
+    saidaEscrever(saida, texto, strlen(texto));
+}
+
+static inline void saidaCaractere(Saida *saida, char c) {
+    if (saida->usado == SAIDA_TAM_BUFFER) {
+        saidaEsvaziar(saida);
+    }
+    saida->buffer[saida->usado++] = c;
+}
+
+void saidaEspacos(Saida *saida, size_t n);
+
+void saidaInteiro(Saida *saida, long long valor);
+
+/* Caracteres que saidaInteiro escreve para 'valor' */
+int saidaLarguraInteiro(long long valor);
+
+/* Campos alinhados a esquerda e completados com espacos (como "%-Ns") */
+void saidaCampo(Saida *saida, const char *texto, int largura);
+
+void saidaCampoN(Saida *saida, const char *texto, size_t n, int largura);
+
+/* Inteiro alinhado a esquerda (como "%-Nd") */
+void saidaCampoInteiro(Saida *saida, long long valor, int largura);
+
+#endif
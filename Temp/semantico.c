@@ -1,284 +1,463 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
+#include <stdarg.h>
 #include "semantico.h"
 #include "simbolos.h"
 #include "arvore.h"
+#include "contexto.h"
+#include "paralelo.h"
 
-/* Contador global de erros semanticos */
-int errosSemanticos = 0;
+/* Estado de uma analise: a do programa ou a do corpo de uma funcao */
+typedef struct {
+    const Arvore *arvore;
+    const TabelaAtomos *atomos;   /* So leitura: a analise nao interna nomes */
+    TabelaSimbolos *simbolos;     /* Onde entram as declaracoes encontradas */
+    Escopo *global;
+    Escopo *escopoAtual;
+    int erros;
+    SaidaMemoria mensagens;       /* Criada no primeiro erro */
+} Analise;
 
-/* Escopo atual durante a analise */
-static char escopoAtual[50] = "global";
+/*
+ * Declaracao do topo do programa. As variaveis globais e as assinaturas sao
+ * registradas em serie; os corpos das funcoes sao analisados em paralelo,
+ * cada um com uma tabela local que so enxerga o que veio antes dele.
+ */
+typedef struct {
+    NoId no;
+    Simbolo *desde;               /* Ultimo simbolo global antes da declaracao */
+    Simbolo *ate;                 /* Ultimo simbolo global depois dela */
+    TabelaSimbolos locais;        /* Escopos da funcao (so em FUN_DEF) */
+    Analise analise;
+} DeclaracaoTopo;
 
 /* Prototipos das funcoes auxiliares */
-static void analisarNo(NoArvore *no);
-static void analisarDeclaracaoVariavel(NoArvore *no);
-static void analisarDeclaracaoFuncao(NoArvore *no);
-static void analisarParametros(NoArvore *no);
+static void analisarNo(Analise *an, NoId no);
+static void analisarDeclaracaoVariavel(Analise *an, NoId no);
+static void analisarDeclaracaoFuncao(Analise *an, NoId no);
+static void analisarAssinaturaFuncao(Analise *an, NoId no);
+static void analisarCorpoFuncao(Analise *an, NoId no);
+static void analisarParametros(Analise *an, NoId no);
 
-void inicializarFuncoesPredefinidas(void) {
+/*
+ * reportarErro - Guarda uma mensagem de erro da analise e conta o erro.
+ * As mensagens sao escritas depois, na ordem do fonte.
+ */
+static void reportarErro(Analise *an, const char *formato, ...) {
+    if (an->mensagens.arquivo == NULL && abrirSaidaMemoria(&an->mensagens) == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para as mensagens\n");
+        exit(1);
+    }
+
+    va_list args;
+    va_start(args, formato);
+    vfprintf(an->mensagens.arquivo, formato, args);
+    va_end(args);
+    an->erros++;
+}
+
+/* Escreve as mensagens guardadas e soma os erros no contexto */
+static void descarregarAnalise(ContextoCompilador *ctx, Analise *an) {
+    fecharSaidaMemoria(&an->mensagens);
+    if (an->mensagens.texto != NULL) {
+        fwrite(an->mensagens.texto, 1, an->mensagens.tamanho, ctx->mensagens);
+        free(an->mensagens.texto);
+        an->mensagens.texto = NULL;
+    }
+    ctx->errosSemanticos += an->erros;
+}
+
+static void iniciarAnalise(Analise *an, ContextoCompilador *ctx, TabelaSimbolos *simbolos) {
+    SaidaMemoria vazia = SAIDA_MEMORIA_INICIAL;
+    an->arvore = &ctx->arvore;
+    an->atomos = &ctx->atomos;
+    an->simbolos = simbolos;
+    an->global = escopoGlobal(&ctx->simbolos);
+    an->escopoAtual = an->global;
+    an->erros = 0;
+    an->mensagens = vazia;
+}
+
+void inicializarFuncoesPredefinidas(ContextoCompilador *ctx) {
     /* input: funcao que retorna int, sem parametros */
-    inserirSimbolo("input", "int", "global", 0, 1, 0);
+    inserirSimbolo(&ctx->simbolos, ATOMO_INPUT, TIPO_INT, escopoGlobal(&ctx->simbolos), 0, 1, 0);
     
     /* output: funcao void que recebe um int */
-    inserirSimbolo("output", "void", "global", 0, 1, 1);
+    inserirSimbolo(&ctx->simbolos, ATOMO_OUTPUT, TIPO_VOID, escopoGlobal(&ctx->simbolos), 0, 1, 1);
+}
+
+/* Tarefa paralela: analisa o corpo da i-esima declaracao, se for funcao */
+static void analisarCorpoDeclaracao(void *dados, int i) {
+    DeclaracaoTopo *d = &((DeclaracaoTopo*) dados)[i];
+    if (tipoNo(d->analise.arvore, d->no) == NO_FUN_DEF) {
+        analisarCorpoFuncao(&d->analise, d->no);
+    }
+}
+
+/*
+ * juntarSimbolos - Refaz a ordem de insercao como se tudo tivesse sido
+ * analisado em serie: os globais de cada declaracao seguidos dos locais
+ */
+static void juntarSimbolos(TabelaSimbolos *ts, const Arvore *a, DeclaracaoTopo *decls, int n) {
+    for (int i = 0; i < n; i++) {
+        DeclaracaoTopo *d = &decls[i];
+
+        if (d->ate != d->desde) {
+            Simbolo *maisAntigo = d->ate;
+            while (maisAntigo->prox != d->desde) {
+                maisAntigo = maisAntigo->prox;
+            }
+            maisAntigo->prox = ts->ultimo;
+            ts->ultimo = d->ate;
+        }
+        if (tipoNo(a, d->no) == NO_FUN_DEF) {
+            incorporarSimbolos(ts, &d->locais);
+        }
+    }
 }
 
-int analisarSemantica(NoArvore *raiz) {
+int analisarSemantica(ContextoCompilador *ctx) {
     /* Reseta contadores */
-    errosSemanticos = 0;
-    strcpy(escopoAtual, "global");
+    ctx->errosSemanticos = 0;
     
     /* Insere funcoes pre-definidas na tabela */
-    inicializarFuncoesPredefinidas();
+    inicializarFuncoesPredefinidas(ctx);
+    Simbolo *predefinidos = ctx->simbolos.ultimo;
     
-    /* Percorre a arvore a partir da raiz */
-    if (raiz != NULL) {
-        analisarNo(raiz);
+    /* Cada uso de nome guarda o simbolo resolvido e cada expressao o tipo */
+    reservarAnotacoes(&ctx->arvore);
+    
+    int n = 0;
+    NoId *nos = ctx->raiz != NO_NULO ? coletarDeclaracoes(&ctx->arvore, ctx->raiz, &n) : NULL;
+    DeclaracaoTopo *decls = (DeclaracaoTopo*) calloc((size_t) (n > 0 ? n : 1), sizeof(DeclaracaoTopo));
+    if (decls == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a analise semantica\n");
+        exit(1);
     }
     
-    if (buscarSimbolo("main", "global") == NULL) {
-        printf("ERRO SEMANTICO: funcao 'main' nao declarada LINHA: 0\n");
-        errosSemanticos++;
+    /* Fase 1 (em serie): globais e assinaturas, na ordem do fonte */
+    for (int i = 0; i < n; i++) {
+        DeclaracaoTopo *d = &decls[i];
+        d->no = nos[i];
+        d->desde = ctx->simbolos.ultimo;
+        iniciarAnalise(&d->analise, ctx, &ctx->simbolos);
+        
+        if (tipoNo(&ctx->arvore, d->no) == NO_FUN_DEF) {
+            analisarAssinaturaFuncao(&d->analise, d->no);
+            /* O corpo enxerga os globais anteriores e a propria funcao */
+            iniciarTabelaLocal(&d->locais, &ctx->simbolos);
+            d->analise.simbolos = &d->locais;
+        } else {
+            analisarNo(&d->analise, d->no);
+        }
+        d->ate = ctx->simbolos.ultimo;
     }
     
-    return errosSemanticos;
-}
-
-static void analisarNo(NoArvore *no) {
-    if (no == NULL) return;
+    /* Fase 2 (em paralelo): corpos das funcoes, cada um na sua tabela */
+    executarEmParalelo(n, ctx->numThreads, analisarCorpoDeclaracao, decls);
     
-    if (strcmp(no->tipo, "VAR") == 0 || strcmp(no->tipo, "ARRAY_VAR") == 0) {
-        analisarDeclaracaoVariavel(no);
+    /* Junta mensagens e simbolos na ordem do fonte */
+    ctx->simbolos.ultimo = predefinidos;
+    juntarSimbolos(&ctx->simbolos, &ctx->arvore, decls, n);
+    for (int i = 0; i < n; i++) {
+        descarregarAnalise(ctx, &decls[i].analise);
     }
+    free(decls);
+    free(nos);
     
-    else if (strcmp(no->tipo, "FUN_DEF") == 0) {
-        analisarDeclaracaoFuncao(no);
+    if (buscarSimbolo(&ctx->simbolos, ATOMO_MAIN, escopoGlobal(&ctx->simbolos)) == NULL) {
+        fprintf(ctx->mensagens, "ERRO SEMANTICO: funcao 'main' nao declarada LINHA: 0\n");
+        ctx->errosSemanticos++;
     }
     
-    else if (strcmp(no->tipo, "ID") == 0) {
-        Simbolo *s = buscarSimbolo(no->valor, escopoAtual);
-        if (s == NULL) {
-            printf("ERRO SEMANTICO: variavel '%s' nao declarada LINHA: %d\n", 
-                   no->valor, no->linha);
-            errosSemanticos++;
+    return ctx->errosSemanticos;
+}
+
+/*
+ * definirTipo - Anota o tipo de uma expressao. Cada no e anotado por uma
+ * unica analise, como os simbolos.
+ */
+static void definirTipo(const Arvore *a, NoId no, TipoDado tipo) {
+    a->tiposDado[no] = (unsigned char) tipo;
+}
+
+/*
+ * concluirNo - Parte da analise que vem depois dos filhos: verificacao de
+ * tipos com os tipos ja anotados nos operandos (os erros deles saem antes)
+ * e saida de escopo
+ */
+static void concluirNo(Analise *an, NoId no) {
+    const Arvore *a = an->arvore;
+    NoId esq = primeiroFilho(a, no);
+    NoId dir = esq != NO_NULO ? proximoIrmao(a, esq) : NO_NULO;
+    TipoDado tipoEsq = esq != NO_NULO ? tipoDadoNo(a, esq) : TIPO_NENHUM;
+    TipoDado tipoDir = dir != NO_NULO ? tipoDadoNo(a, dir) : TIPO_NENHUM;
+    
+    switch (tipoNo(a, no)) {
+    case NO_ATRIB:
+        /* A atribuicao tem o tipo da variavel; os dois lados devem casar */
+        definirTipo(a, no, tipoEsq);
+        if (tipoEsq != TIPO_NENHUM && tipoDir != TIPO_NENHUM && tipoEsq != tipoDir) {
+            reportarErro(an, "ERRO SEMANTICO: atribuicao de tipo incompatível ('%s' = '%s') LINHA: %d\n",
+                         nomeTipoDado(tipoEsq), nomeTipoDado(tipoDir), linhaNo(a, no));
         }
-    }
+        break;
     
-    else if (strcmp(no->tipo, "ID_ARRAY") == 0) {
-        Simbolo *s = buscarSimbolo(no->valor, escopoAtual);
-        if (s == NULL) {
-            printf("ERRO SEMANTICO: array '%s' nao declarado LINHA: %d\n", 
-                   no->valor, no->linha);
-            errosSemanticos++;
+    /* Verificação de tipos em operações aritméticas (o resultado e int) */
+    case NO_SOMA:
+    case NO_SUB:
+    case NO_MULT:
+    case NO_DIV:
+        if ((tipoEsq != TIPO_NENHUM && tipoEsq != TIPO_INT) || (tipoDir != TIPO_NENHUM && tipoDir != TIPO_INT)) {
+            reportarErro(an, "ERRO SEMANTICO: operacao aritmetica com tipo nao inteiro ('%s' e '%s') LINHA: %d\n",
+                         nomeTipoDado(tipoEsq), nomeTipoDado(tipoDir), linhaNo(a, no));
         }
-        /* Analisa a expressao do indice */
-        for (int i = 0; i < no->nFilhos; i++) {
-            analisarNo(no->filhos[i]);
+        /* Divisor literal zero (o parser nao dobra essas divisoes) */
+        if (tipoNo(a, no) == NO_DIV && dir != NO_NULO && tipoNo(a, dir) == NO_NUM &&
+            valorLiteral(a, dir) == 0) {
+            reportarErro(an, "ERRO SEMANTICO: divisao por zero LINHA: %d\n", linhaNo(a, no));
         }
+        break;
+    
+    case NO_BLOCO:
+        an->escopoAtual = sairEscopo(an->escopoAtual);
+        break;
+    
+    default:
+        break;
     }
+}
+
+/* Quadro do percurso da analise: cada no e visitado na ida e, se precisar,
+   de novo na volta (depois de todos os filhos) */
+typedef struct {
+    NoId no;
+    int volta;
+} QuadroAnalise;
+
+static void empilharQuadroAnalise(PilhaPercurso *pilha, NoId no, int volta) {
+    QuadroAnalise *q = (QuadroAnalise*) empilhar(pilha);
+    q->no = no;
+    q->volta = volta;
+}
+
+/*
+ * analisarNo - Percorre a subarvore em pre-ordem com uma pilha explicita,
+ * sem limite de profundidade
+ */
+static void analisarNo(Analise *an, NoId raiz) {
+    const Arvore *a = an->arvore;
+    PilhaPercurso pilha = PILHA_PERCURSO_INICIAL(QuadroAnalise);
+    empilharQuadroAnalise(&pilha, raiz, 0);
     
-    else if (strcmp(no->tipo, "ATRIB") == 0) {
-        // Verifica tipos do lado esquerdo e direito
-        char tipo_esq[20] = "", tipo_dir[20] = "";
-        // Lado esquerdo (variável)
-        if (no->nFilhos >= 1 && no->filhos[0] != NULL) {
-            analisarNo(no->filhos[0]);
-            NoArvore *esq = no->filhos[0];
-            if (strcmp(esq->tipo, "ID") == 0 || strcmp(esq->tipo, "ID_ARRAY") == 0) {
-                Simbolo *s = buscarSimbolo(esq->valor, escopoAtual);
-                if (!s && strcmp(esq->tipo, "ID") == 0) s = buscarSimbolo(esq->valor, "global");
-                if (s) {
-                    strcpy(tipo_esq, s->tipo);
-                    // Se for acesso a array, remove []
-                    if (strcmp(esq->tipo, "ID_ARRAY") == 0 && strlen(tipo_esq) > 2) {
-                        tipo_esq[strlen(tipo_esq) - 2] = '\0';
-                    }
-                }
-            }
+    while (pilha.total > 0) {
+        QuadroAnalise q = *(QuadroAnalise*) desempilhar(&pilha);
+        NoId no = q.no;
+        if (no == NO_NULO) continue;
+        
+        if (q.volta) {
+            concluirNo(an, no);
+            continue;
         }
-        // Lado direito (expressão)
-        if (no->nFilhos >= 2 && no->filhos[1] != NULL) {
-            analisarNo(no->filhos[1]);
-            NoArvore *dir = no->filhos[1];
-            if (strcmp(dir->tipo, "ID") == 0 || strcmp(dir->tipo, "ID_ARRAY") == 0) {
-                Simbolo *s = buscarSimbolo(dir->valor, escopoAtual);
-                if (!s && strcmp(dir->tipo, "ID") == 0) s = buscarSimbolo(dir->valor, "global");
-                if (s) {
-                    strcpy(tipo_dir, s->tipo);
-                    // Se for acesso a array, remove []
-                    if (strcmp(dir->tipo, "ID_ARRAY") == 0 && strlen(tipo_dir) > 2) {
-                        tipo_dir[strlen(tipo_dir) - 2] = '\0';
-                    }
-                }
-            } else if (strcmp(dir->tipo, "NUM") == 0) {
-                strcpy(tipo_dir, "int");
-            }
+        
+        /* O irmao seguinte espera a subarvore deste no */
+        if (no != raiz && proximoIrmao(a, no) != NO_NULO) {
+            empilharQuadroAnalise(&pilha, proximoIrmao(a, no), 0);
         }
-        // Verifica compatibilidade de tipos (simples: ambos int)
-        if (tipo_esq[0] && tipo_dir[0] && strcmp(tipo_esq, tipo_dir) != 0) {
-            printf("ERRO SEMANTICO: atribuicao de tipo incompatível ('%s' = '%s') LINHA: %d\n", tipo_esq, tipo_dir, no->linha);
-            errosSemanticos++;
+        
+        switch (tipoNo(a, no)) {
+        case NO_VAR:
+        case NO_ARRAY_VAR:
+            analisarDeclaracaoVariavel(an, no);
+            continue;
+        
+        case NO_FUN_DEF:
+            analisarDeclaracaoFuncao(an, no);
+            continue;
+        
+        /* Os usos de nomes sao resolvidos aqui, uma vez, e ficam no no (cada
+           no e escrito por uma unica analise, entao nao ha disputa) */
+        case NO_ID: {
+            Simbolo *s = buscarSimbolo(an->simbolos, valorNo(a, no), an->escopoAtual);
+            a->simbolos[no] = s;
+            if (s == NULL) {
+                reportarErro(an, "ERRO SEMANTICO: variavel '%s' nao declarada LINHA: %d\n",
+                             nomeAtomo(an->atomos, valorNo(a, no)), linhaNo(a, no));
+            } else {
+                definirTipo(a, no, s->tipo);
+            }
+            break;
         }
-    }
-    /* Verificação de tipos em operações aritméticas */
-    else if (strcmp(no->tipo, "SOMA") == 0 || strcmp(no->tipo, "SUB") == 0 || strcmp(no->tipo, "MULT") == 0 || strcmp(no->tipo, "DIV") == 0) {
-        char tipo_esq[20] = "", tipo_dir[20] = "";
-        if (no->nFilhos >= 1 && no->filhos[0] != NULL) {
-            analisarNo(no->filhos[0]);
-            NoArvore *esq = no->filhos[0];
-            if (strcmp(esq->tipo, "ID") == 0 || strcmp(esq->tipo, "ID_ARRAY") == 0) {
-                Simbolo *s = buscarSimbolo(esq->valor, escopoAtual);
-                if (!s && strcmp(esq->tipo, "ID") == 0) s = buscarSimbolo(esq->valor, "global");
-                if (s) {
-                    strcpy(tipo_esq, s->tipo);
-                    // Se for acesso a array, remove []
-                    if (strcmp(esq->tipo, "ID_ARRAY") == 0 && strlen(tipo_esq) > 2) {
-                        tipo_esq[strlen(tipo_esq) - 2] = '\0';
-                    }
-                }
-            } else if (strcmp(esq->tipo, "NUM") == 0) {
-                strcpy(tipo_esq, "int");
+        
+        case NO_ID_ARRAY: {
+            Simbolo *s = buscarSimbolo(an->simbolos, valorNo(a, no), an->escopoAtual);
+            a->simbolos[no] = s;
+            if (s == NULL) {
+                reportarErro(an, "ERRO SEMANTICO: array '%s' nao declarado LINHA: %d\n",
+                             nomeAtomo(an->atomos, valorNo(a, no)), linhaNo(a, no));
+            } else {
+                definirTipo(a, no, tipoElemento(s->tipo));
             }
+            /* Os filhos (expressao do indice) sao empilhados abaixo */
+            break;
         }
-        if (no->nFilhos >= 2 && no->filhos[1] != NULL) {
-            analisarNo(no->filhos[1]);
-            NoArvore *dir = no->filhos[1];
-            if (strcmp(dir->tipo, "ID") == 0 || strcmp(dir->tipo, "ID_ARRAY") == 0) {
-                Simbolo *s = buscarSimbolo(dir->valor, escopoAtual);
-                if (!s && strcmp(dir->tipo, "ID") == 0) s = buscarSimbolo(dir->valor, "global");
-                if (s) {
-                    strcpy(tipo_dir, s->tipo);
-                    // Se for acesso a array, remove []
-                    if (strcmp(dir->tipo, "ID_ARRAY") == 0 && strlen(tipo_dir) > 2) {
-                        tipo_dir[strlen(tipo_dir) - 2] = '\0';
-                    }
-                }
-            } else if (strcmp(dir->tipo, "NUM") == 0) {
-                strcpy(tipo_dir, "int");
+        
+        case NO_CHAMADA_FUNCAO: {
+            /* Funcoes sempre estao no escopo global; os argumentos vem abaixo.
+               A chamada tem o tipo de retorno */
+            Simbolo *s = buscarSimbolo(an->simbolos, valorNo(a, no), an->global);
+            a->simbolos[no] = s;
+            if (s != NULL) {
+                definirTipo(a, no, s->tipo);
             }
+            break;
         }
-        if ((tipo_esq[0] && strcmp(tipo_esq, "int") != 0) || (tipo_dir[0] && strcmp(tipo_dir, "int") != 0)) {
-            printf("ERRO SEMANTICO: operacao aritmetica com tipo nao inteiro ('%s' e '%s') LINHA: %d\n", tipo_esq, tipo_dir, no->linha);
-            errosSemanticos++;
+        
+        case NO_NUM:
+        case NO_REL:
+            definirTipo(a, no, TIPO_INT);
+            break;
+        
+        case NO_SOMA:
+        case NO_SUB:
+        case NO_MULT:
+        case NO_DIV:
+            definirTipo(a, no, TIPO_INT);
+            empilharQuadroAnalise(&pilha, no, 1);
+            break;
+        
+        case NO_ATRIB:
+            empilharQuadroAnalise(&pilha, no, 1);
+            break;
+        
+        /* Bloco aninhado: declaracoes internas ficam num escopo proprio */
+        case NO_BLOCO:
+            an->escopoAtual = entrarEscopo(an->simbolos, an->escopoAtual, an->escopoAtual->nome);
+            empilharQuadroAnalise(&pilha, no, 1);
+            break;
+        
+        default:
+            break;
+        }
+        
+        /* O primeiro filho sai antes; os irmaos dele vem em seguida */
+        if (primeiroFilho(a, no) != NO_NULO) {
+            empilharQuadroAnalise(&pilha, primeiroFilho(a, no), 0);
         }
     }
     
-    else {
-        for (int i = 0; i < no->nFilhos; i++) {
-            analisarNo(no->filhos[i]);
-        }
+    liberarPilha(&pilha);
+}
+
+/* Tipo do filho NO_TIPO, simples ou vetor (TIPO_NENHUM se nao houver) */
+static TipoDado tipoDeclarado(Analise *an, NoId no, int vetor) {
+    NoId filho = primeiroFilho(an->arvore, no);
+    if (filho == NO_NULO || tipoNo(an->arvore, filho) != NO_TIPO) {
+        return TIPO_NENHUM;
     }
+    return tipoEspecificado(valorNo(an->arvore, filho), vetor);
 }
 
-static void analisarDeclaracaoVariavel(NoArvore *no) {
-    if (no == NULL) return;
+static void analisarDeclaracaoVariavel(Analise *an, NoId no) {
+    if (no == NO_NULO) return;
     
-    char tipo[20] = "";
-    char *nome = no->valor;
+    Atomo nome = valorNo(an->arvore, no);
     
-    /* Extrai o tipo do primeiro filho */
-    if (no->nFilhos > 0 && no->filhos[0] != NULL) {
-        if (strcmp(no->filhos[0]->tipo, "TIPO") == 0) {
-            strcpy(tipo, no->filhos[0]->valor);
-        }
-    }
-    
-    /* Se for array, ajusta o tipo */
-    if (strcmp(no->tipo, "ARRAY_VAR") == 0) {
-        strcat(tipo, "[]");
-    }
+    /* Extrai o tipo do primeiro filho (vetor se for array) */
+    TipoDado tipo = tipoDeclarado(an, no, tipoNo(an->arvore, no) == NO_ARRAY_VAR);
     
     /* Tenta inserir na tabela */
-    if (!inserirSimbolo(nome, tipo, escopoAtual, no->linha, 0, 0)) {
-        printf("ERRO SEMANTICO: variavel '%s' ja declarada neste escopo LINHA: %d\n", 
-               nome, no->linha);
-        errosSemanticos++;
+    if (!inserirSimbolo(an->simbolos, nome, tipo, an->escopoAtual, linhaNo(an->arvore, no), 0, 0)) {
+        reportarErro(an, "ERRO SEMANTICO: variavel '%s' ja declarada neste escopo LINHA: %d\n",
+                     nomeAtomo(an->atomos, nome), linhaNo(an->arvore, no));
     }
 }
 
-static void analisarDeclaracaoFuncao(NoArvore *no) {
-    if (no == NULL) return;
+static void analisarDeclaracaoFuncao(Analise *an, NoId no) {
+    analisarAssinaturaFuncao(an, no);
+    analisarCorpoFuncao(an, no);
+}
+
+/*
+ * analisarAssinaturaFuncao - Registra a funcao no escopo global
+ */
+static void analisarAssinaturaFuncao(Analise *an, NoId no) {
+    if (no == NO_NULO) return;
     
-    char tipo[20] = "";
-    char *nomeFuncao = no->valor;
+    const Arvore *a = an->arvore;
+    Atomo nomeFuncao = valorNo(a, no);
     int numParams = 0;
     
     /* Extrai tipo de retorno */
-    if (no->nFilhos > 0 && no->filhos[0] != NULL) {
-        if (strcmp(no->filhos[0]->tipo, "TIPO") == 0) {
-            strcpy(tipo, no->filhos[0]->valor);
-        }
-    }
+    TipoDado tipo = tipoDeclarado(an, no, 0);
     
     /* Conta parametros */
-    if (no->nFilhos > 1 && no->filhos[1] != NULL) {
-        NoArvore *params = no->filhos[1];
-        if (strcmp(params->tipo, "PARAMS") == 0) {
-            if (params->valor[0] != '\0' && strcmp(params->valor, "void") == 0) {
-                numParams = 0;
-            } else if (params->nFilhos > 0) {
-                numParams = 1;
-            }
+    NoId params = filhoNo(a, no, 1);
+    if (params != NO_NULO && tipoNo(a, params) == NO_PARAMS) {
+        if (valorNo(a, params) == ATOMO_VOID) {
+            numParams = 0;
+        } else if (primeiroFilho(a, params) != NO_NULO) {
+            /* A lista e plana: um filho por parametro */
+            NoId lista = primeiroFilho(a, params);
+            numParams = tipoNo(a, lista) == NO_PARAM_LIST ? numFilhos(a, lista) : 1;
         }
     }
     
     /* Insere a funcao na tabela (sempre no escopo global) */
-    if (!inserirSimbolo(nomeFuncao, tipo, "global", no->linha, 1, numParams)) {
-        printf("ERRO SEMANTICO: funcao '%s' ja declarada LINHA: %d\n", 
-               nomeFuncao, no->linha);
-        errosSemanticos++;
+    if (!inserirSimbolo(an->simbolos, nomeFuncao, tipo, an->global, linhaNo(a, no), 1, numParams)) {
+        reportarErro(an, "ERRO SEMANTICO: funcao '%s' ja declarada LINHA: %d\n",
+                     nomeAtomo(an->atomos, nomeFuncao), linhaNo(a, no));
     }
+}
+
+/*
+ * analisarCorpoFuncao - Analisa parametros e corpo no escopo da funcao
+ */
+static void analisarCorpoFuncao(Analise *an, NoId no) {
+    if (no == NO_NULO) return;
     
-    /* Salva escopo atual e muda para dentro da funcao */
-    char escopoAnterior[50];
-    strcpy(escopoAnterior, escopoAtual);
-    strcpy(escopoAtual, nomeFuncao);
+    Atomo nomeFuncao = valorNo(an->arvore, no);
+    
+    /* Empilha o escopo da funcao (parametros e locais do corpo) */
+    an->escopoAtual = entrarEscopo(an->simbolos, an->escopoAtual, nomeFuncao);
     
     /* Processa parametros */
-    if (no->nFilhos > 1 && no->filhos[1] != NULL) {
-        analisarParametros(no->filhos[1]);
+    NoId params = filhoNo(an->arvore, no, 1);
+    if (params != NO_NULO) {
+        analisarParametros(an, params);
     }
     
     /* Analisa o corpo da funcao */
-    if (no->nFilhos > 2 && no->filhos[2] != NULL) {
-        analisarNo(no->filhos[2]);
+    NoId corpo = filhoNo(an->arvore, no, 2);
+    if (corpo != NO_NULO) {
+        analisarNo(an, corpo);
     }
     
-    /* Restaura escopo anterior */
-    strcpy(escopoAtual, escopoAnterior);
+    /* Desempilha o escopo da funcao */
+    an->escopoAtual = sairEscopo(an->escopoAtual);
 }
 
-static void analisarParametros(NoArvore *no) {
-    if (no == NULL) return;
+static void analisarParametros(Analise *an, NoId no) {
+    if (no == NO_NULO) return;
+    
+    const Arvore *a = an->arvore;
     
     /* Se for um parametro, insere na tabela */
-    if (strcmp(no->tipo, "PARAM") == 0 || strcmp(no->tipo, "PARAM_ARRAY") == 0) {
-        char tipo[20] = "";
-        char *nome = no->valor;
+    if (tipoNo(a, no) == NO_PARAM || tipoNo(a, no) == NO_PARAM_ARRAY) {
+        Atomo nome = valorNo(a, no);
         
-        /* Extrai o tipo */
-        if (no->nFilhos > 0 && no->filhos[0] != NULL) {
-            if (strcmp(no->filhos[0]->tipo, "TIPO") == 0) {
-                strcpy(tipo, no->filhos[0]->valor);
-            }
-        }
-        
-        if (strcmp(no->tipo, "PARAM_ARRAY") == 0) {
-            strcat(tipo, "[]");
-        }
+        /* Extrai o tipo (vetor se for parametro array) */
+        TipoDado tipo = tipoDeclarado(an, no, tipoNo(a, no) == NO_PARAM_ARRAY);
         
         /* Insere como variavel local */
-        if (!inserirSimbolo(nome, tipo, escopoAtual, no->linha, 0, 0)) {
-            printf("ERRO SEMANTICO: parametro '%s' ja declarado LINHA: %d\n", 
-                   nome, no->linha);
-            errosSemanticos++;
+        if (!inserirSimbolo(an->simbolos, nome, tipo, an->escopoAtual, linhaNo(a, no), 0, 0)) {
+            reportarErro(an, "ERRO SEMANTICO: parametro '%s' ja declarado LINHA: %d\n",
+                         nomeAtomo(an->atomos, nome), linhaNo(a, no));
         }
     }
     
     /* Percorre filhos recursivamente */
-    for (int i = 0; i < no->nFilhos; i++) {
-        analisarParametros(no->filhos[i]);
+    for (NoId f = primeiroFilho(a, no); f != NO_NULO; f = proximoIrmao(a, f)) {
+        analisarParametros(an, f);
     }
 }
@@ -1,13 +1,11 @@
 #ifndef SEMANTICO_H
 #define SEMANTICO_H
 
-#include "arvore.h"
+#include "contexto.h"
 
-/* Contador de erros semanticos encontrados */
-extern int errosSemanticos;
+/* Analisa ctx->raiz; os erros ficam em ctx->errosSemanticos */
+int analisarSemantica(ContextoCompilador *ctx);
 
-int analisarSemantica(NoArvore *raiz);
-
-void inicializarFuncoesPredefinidas(void);
+void inicializarFuncoesPredefinidas(ContextoCompilador *ctx);
 
 #endif
@@ -3,101 +3,255 @@
 #include <string.h>
 #include "simbolos.h"
 
-/* Ponteiro para o inicio da lista (cabeca da tabela) */
-static Simbolo *tabela = NULL;
+/* Capacidade inicial da tabela de espalhamento (potencia de 2) */
+#define CAPACIDADE_INICIAL 256
 
-int inserirSimbolo(const char *nome, const char *tipo, const char *escopo, 
-                   int linha, int ehFuncao, int numParams) {
-    
-    if (buscarSimboloNoEscopo(nome, escopo) != NULL) {
-        return 0;  /* Simbolo ja existe - nao insere */
+/*
+ * hashChave - Mistura nome (atomo) e id do escopo num unico hash
+ */
+static unsigned int hashChave(Atomo nome, unsigned int escopo) {
+    unsigned int h = nome * 0x9E3779B1u ^ escopo * 0x85EBCA77u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+/*
+ * localizar - Devolve a posicao do simbolo (nome, escopo) ou a posicao
+ * livre onde ele deveria ser inserido
+ */
+static unsigned int localizar(const TabelaSimbolos *ts, Atomo nome, const Escopo *escopo) {
+    unsigned int mascara = ts->capacidade - 1;
+    unsigned int i = hashChave(nome, escopo->id) & mascara;
+
+    while (ts->posicoes[i] != NULL) {
+        if (ts->posicoes[i]->nome == nome && ts->posicoes[i]->escopo == escopo) {
+            break;
+        }
+        i = (i + 1) & mascara;
     }
+    return i;
+}
+
+static Escopo* novoEscopo(TabelaSimbolos *ts, Atomo nome, Escopo *pai) {
+    Escopo *e = (Escopo*) arenaAlocar(&ts->arena, sizeof(Escopo));
+    e->id = ts->proximoEscopo++;
+    e->nome = nome;
+    e->nivel = pai ? pai->nivel + 1 : 0;
+    e->pai = pai;
+    e->anterior = ts->ultimoEscopo;
+    ts->ultimoEscopo = e;
+    return e;
+}
+
+Escopo* escopoGlobal(TabelaSimbolos *ts) {
+    if (ts->global == NULL) {
+        ts->global = novoEscopo(ts, ATOMO_GLOBAL, NULL);
+    }
+    return ts->global;
+}
+
+/*
+ * entrarEscopo - Empilha um escopo filho do atual (funcao ou bloco)
+ */
+Escopo* entrarEscopo(TabelaSimbolos *ts, Escopo *atual, Atomo nome) {
+    return novoEscopo(ts, nome, atual);
+}
+
+/*
+ * sairEscopo - Desempilha: volta para o escopo que envolve o atual
+ */
+Escopo* sairEscopo(Escopo *atual) {
+    return atual->pai;
+}
+
+/*
+ * redimensionar - Dobra a tabela e reposiciona os simbolos existentes
+ */
+static void redimensionar(TabelaSimbolos *ts) {
+    Simbolo **antigas = ts->posicoes;
+    unsigned int capacidadeAntiga = ts->capacidade;
 
-    Simbolo *novo = (Simbolo*) malloc(sizeof(Simbolo));
-    if (novo == NULL) {
-        fprintf(stderr, "Erro: falha ao alocar memoria para simbolo\n");
+    ts->capacidade = ts->capacidade ? ts->capacidade * 2 : CAPACIDADE_INICIAL;
+    ts->posicoes = (Simbolo**) calloc(ts->capacidade, sizeof(Simbolo*));
+    if (ts->posicoes == NULL) {
+        fprintf(stderr, "Erro: falha ao alocar memoria para a tabela de simbolos\n");
         exit(1);
     }
 
-    strncpy(novo->nome, nome, sizeof(novo->nome) - 1);
-    novo->nome[sizeof(novo->nome) - 1] = '\0';
-    
-    strncpy(novo->tipo, tipo, sizeof(novo->tipo) - 1);
-    novo->tipo[sizeof(novo->tipo) - 1] = '\0';
-    
-    strncpy(novo->escopo, escopo, sizeof(novo->escopo) - 1);
-    novo->escopo[sizeof(novo->escopo) - 1] = '\0';
-    
+    for (unsigned int i = 0; i < capacidadeAntiga; i++) {
+        if (antigas[i] != NULL) {
+            ts->posicoes[localizar(ts, antigas[i]->nome, antigas[i]->escopo)] = antigas[i];
+        }
+    }
+    free(antigas);
+}
+
+int inserirSimbolo(TabelaSimbolos *ts, Atomo nome, TipoDado tipo, Escopo *escopo,
+                   int linha, int ehFuncao, int numParams) {
+
+    /* Mantem a ocupacao abaixo de 50% */
+    if ((ts->totalSimbolos + 1) * 2 > ts->capacidade) {
+        redimensionar(ts);
+    }
+
+    /* Uma unica sondagem: ou acha o simbolo, ou para na posicao livre */
+    unsigned int i = localizar(ts, nome, escopo);
+    if (ts->posicoes[i] != NULL) {
+        return 0;  /* Simbolo ja existe - nao insere */
+    }
+
+    Simbolo *novo = (Simbolo*) arenaAlocar(&ts->arena, sizeof(Simbolo));
+
+    novo->nome = nome;
+
+    novo->tipo = tipo;
+
+    novo->escopo = escopo;
+
     novo->linha = linha;
     novo->ehFuncao = ehFuncao;
     novo->numParametros = numParams;
+    novo->sequencia = ts->totalSimbolos;
 
-    novo->prox = tabela;
-    tabela = novo;
+    novo->prox = ts->ultimo;
+    ts->ultimo = novo;
+
+    ts->posicoes[i] = novo;
+    ts->totalSimbolos++;
 
     return 1;  /* Inserido com sucesso */
 }
 
-Simbolo* buscarSimboloNoEscopo(const char *nome, const char *escopo) {
-    Simbolo *atual = tabela;
-    
-    /* Percorre toda a lista */
-    while (atual != NULL) {
-        /* Compara nome E escopo */
-        if (strcmp(atual->nome, nome) == 0 && 
-            strcmp(atual->escopo, escopo) == 0) {
-            return atual;  /* Encontrou! */
+Simbolo* buscarSimboloNoEscopo(const TabelaSimbolos *ts, Atomo nome, Escopo *escopo) {
+    if (ts->totalSimbolos > 0) {
+        /* Compara nome E escopo (comparacao de inteiros e ponteiros) */
+        Simbolo *s = ts->posicoes[localizar(ts, nome, escopo)];
+        if (s != NULL) {
+            return s;
         }
-        atual = atual->prox;
     }
-    
-    return NULL;  /* Nao encontrou */
-}
 
-Simbolo* buscarSimbolo(const char *nome, const char *escopo) {
-    /* Tenta encontrar no escopo local primeiro */
-    Simbolo *s = buscarSimboloNoEscopo(nome, escopo);
-    if (s != NULL) {
-        return s;
+    /* Escopos de fora da funcao pertencem a tabela envolvente */
+    if (ts->envolvente != NULL) {
+        Simbolo *s = buscarSimboloNoEscopo(ts->envolvente, nome, escopo);
+        if (s != NULL && s->sequencia < ts->visiveisEnvolvente) {
+            return s;
+        }
     }
-    
-    /* Se nao encontrou e nao esta no global, busca no global */
-    if (strcmp(escopo, "global") != 0) {
-        s = buscarSimboloNoEscopo(nome, "global");
+    return NULL;
+}
+
+Simbolo* buscarSimbolo(const TabelaSimbolos *ts, Atomo nome, Escopo *escopo) {
+    /* Do escopo mais interno para fora, ate o global */
+    for (Escopo *e = escopo; e != NULL; e = e->pai) {
+        Simbolo *s = buscarSimboloNoEscopo(ts, nome, e);
+        if (s != NULL) {
+            return s;
+        }
     }
-    
-    return s;
+
+    return NULL;
 }
 
-void imprimirTabelaSimbolos(void) {
-    printf("\n");
-    printf("================================================================================\n");
-    printf("                           TABELA DE SIMBOLOS                                   \n");
-    printf("================================================================================\n");
-    printf("%-20s %-10s %-15s %-8s %-10s\n", 
-           "Nome", "Tipo", "Escopo", "Linha", "Categoria");
-    printf("--------------------------------------------------------------------------------\n");
-    
-    Simbolo *atual = tabela;
-    while (atual != NULL) {
-        printf("%-20s %-10s %-15s %-8d %-10s\n",
-               atual->nome,
-               atual->tipo,
-               atual->escopo,
-               atual->linha,
-               atual->ehFuncao ? "funcao" : "variavel");
-        atual = atual->prox;
+void iniciarTabelaLocal(TabelaSimbolos *ts, const TabelaSimbolos *envolvente) {
+    TabelaSimbolos vazia = TABELA_SIMBOLOS_INICIAL;
+    *ts = vazia;
+    ts->envolvente = envolvente;
+    ts->visiveisEnvolvente = envolvente->totalSimbolos;
+}
+
+/*
+ * incorporarSimbolos - Junta uma tabela local a 'destino': os simbolos
+ * entram no fim da ordem de impressao, como se tivessem sido inseridos
+ * agora, e os blocos da arena passam a ser de 'destino'
+ */
+void incorporarSimbolos(TabelaSimbolos *destino, TabelaSimbolos *origem) {
+    while ((destino->totalSimbolos + origem->totalSimbolos) * 2 > destino->capacidade) {
+        redimensionar(destino);
     }
-    
-    printf("================================================================================\n");
+
+    /* Os ids locais contam de 0; seguem os ja usados em 'destino' */
+    for (Escopo *e = origem->ultimoEscopo; e != NULL; e = e->anterior) {
+        e->id += destino->proximoEscopo;
+    }
+    destino->proximoEscopo += origem->proximoEscopo;
+
+    /* A lista vai do mais novo ao mais antigo; o mais antigo passa a
+       apontar para o antigo fim de 'destino' */
+    Simbolo *maisAntigo = NULL;
+    unsigned int sequencia = destino->totalSimbolos + origem->totalSimbolos;
+    for (Simbolo *s = origem->ultimo; s != NULL; s = s->prox) {
+        s->sequencia = --sequencia;
+        destino->posicoes[localizar(destino, s->nome, s->escopo)] = s;
+        maisAntigo = s;
+    }
+    if (maisAntigo != NULL) {
+        maisAntigo->prox = destino->ultimo;
+        destino->ultimo = origem->ultimo;
+        destino->totalSimbolos += origem->totalSimbolos;
+    }
+
+    /* Os escopos vem junto, mesmo os que nao tem simbolos */
+    arenaIncorporar(&destino->arena, &origem->arena);
+    origem->ultimo = NULL;
+    liberarTabelaSimbolos(origem);
+}
+
+unsigned int numeroDeSimbolos(const TabelaSimbolos *ts) {
+    return ts->totalSimbolos;
 }
 
-void liberarTabelaSimbolos(void) {
-    Simbolo *atual = tabela;
+void imprimirTabelaSimbolos(const TabelaSimbolos *ts, const TabelaAtomos *atomos, Saida *saida) {
+    saidaTexto(saida, "\n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "                           TABELA DE SIMBOLOS                                   \n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "Nome                 Tipo       Escopo          Linha    Categoria \n");
+    saidaTexto(saida, "--------------------------------------------------------------------------------\n");
+
+    /* Campos alinhados como "%-20s %-10s %-15s %-8d %-10s" */
+    Simbolo *atual = ts->ultimo;
     while (atual != NULL) {
-        Simbolo *temp = atual;
+        saidaCampo(saida, nomeAtomo(atomos, atual->nome), 20);
+        saidaCaractere(saida, ' ');
+        saidaCampo(saida, nomeTipoDado(atual->tipo), 10);
+        saidaCaractere(saida, ' ');
+
+        /* Blocos aninhados aparecem como "funcao:nivel" */
+        const char *escopo = nomeAtomo(atomos, atual->escopo->nome);
+        if (atual->escopo->nivel <= 1) {
+            saidaCampo(saida, escopo, 15);
+        } else {
+            size_t n = strlen(escopo);
+            saidaEscrever(saida, escopo, n);
+            saidaCaractere(saida, ':');
+            saidaCampoInteiro(saida, atual->escopo->nivel, 15 - (int) (n + 1));
+        }
+        saidaCaractere(saida, ' ');
+
+        saidaCampoInteiro(saida, atual->linha, 8);
+        saidaCaractere(saida, ' ');
+        saidaCampo(saida, atual->ehFuncao ? "funcao" : "variavel", 10);
+        saidaCaractere(saida, '\n');
         atual = atual->prox;
-        free(temp);  /* Libera o no */
     }
-    tabela = NULL;  /* Reseta o ponteiro da cabeca */
+
+    saidaTexto(saida, "================================================================================\n");
+}
+
+void liberarTabelaSimbolos(TabelaSimbolos *ts) {
+    /* Os simbolos sao devolvidos em bloco junto com a arena */
+    arenaLiberar(&ts->arena);
+    free(ts->posicoes);
+    ts->posicoes = NULL;
+    ts->capacidade = 0;
+    ts->totalSimbolos = 0;
+    ts->ultimo = NULL;  /* Reseta o ponteiro da cabeca */
+    ts->global = NULL;
+    ts->proximoEscopo = 0;
+    ts->ultimoEscopo = NULL;
+    ts->envolvente = NULL;
+    ts->visiveisEnvolvente = 0;
 }
@@ -1,25 +1,79 @@
 #ifndef SIMBOLOS_H
 #define SIMBOLOS_H
 
+#include "atomos.h"
+#include "saida.h"
+#include "tipos.h"
+
+/* Escopo lexico: global, corpo de funcao ou bloco aninhado */
+typedef struct Escopo {
+    unsigned int id;      /* Identificador unico (parte da chave de busca) */
+    Atomo nome;           /* "global" ou nome da funcao que o contem */
+    int nivel;            /* 0 = global, 1 = funcao, 2 ou mais = bloco */
+    struct Escopo *pai;   /* Escopo que envolve este (NULL no global) */
+    struct Escopo *anterior; /* Criado antes deste na mesma tabela */
+} Escopo;
+
 typedef struct Simbolo {
-    char nome[50];        /* Nome do identificador */
-    char tipo[10];        /* Tipo: "int", "void", "int[]" */
-    char escopo[50];      /* Escopo: "global" ou nome da funcao */
+    Atomo nome;           /* Nome do identificador (internado) */
+    TipoDado tipo;        /* Tipo: int, void, int[] */
+    Escopo *escopo;       /* Escopo onde foi declarado */
     int linha;            /* Linha onde foi declarado */
     int ehFuncao;         /* 1 = funcao, 0 = variavel */
     int numParametros;    /* Numero de parametros (se for funcao) */
-    struct Simbolo *prox; /* Ponteiro para proximo simbolo */
+    unsigned int sequencia; /* Ordem de insercao na tabela (0, 1, ...) */
+    struct Simbolo *prox; /* Simbolo inserido antes deste (ordem de impressao) */
 } Simbolo;
 
-int inserirSimbolo(const char *nome, const char *tipo, const char *escopo, 
+typedef struct TabelaSimbolos {
+    Simbolo *ultimo;          /* Ultimo simbolo inserido (cabeca da lista de impressao) */
+    Simbolo **posicoes;       /* Enderecamento aberto por (nome, escopo) */
+    unsigned int capacidade;
+    unsigned int totalSimbolos;
+    Arena arena;              /* Simbolos e escopos (ponteiros estaveis) */
+    Escopo *global;           /* Escopo raiz (criado sob demanda) */
+    unsigned int proximoEscopo;
+    Escopo *ultimoEscopo;     /* Ultimo escopo criado nesta tabela */
+
+    /* Tabela local: o que nao esta aqui e procurado (so leitura) na
+       envolvente, que so mostra os seus 'visiveisEnvolvente' primeiros */
+    const struct TabelaSimbolos *envolvente;
+    unsigned int visiveisEnvolvente;
+} TabelaSimbolos;
+
+/* Tabela vazia, pronta para uso */
+#define TABELA_SIMBOLOS_INICIAL { NULL, NULL, 0, 0, ARENA_INICIAL, NULL, 0, NULL, NULL, 0 }
+
+Escopo* escopoGlobal(TabelaSimbolos *ts);
+
+Escopo* entrarEscopo(TabelaSimbolos *ts, Escopo *atual, Atomo nome);
+
+Escopo* sairEscopo(Escopo *atual);
+
+int inserirSimbolo(TabelaSimbolos *ts, Atomo nome, TipoDado tipo, Escopo *escopo, 
                    int linha, int ehFuncao, int numParams);
 
-Simbolo* buscarSimbolo(const char *nome, const char *escopo);
+Simbolo* buscarSimbolo(const TabelaSimbolos *ts, Atomo nome, Escopo *escopo);
+
+Simbolo* buscarSimboloNoEscopo(const TabelaSimbolos *ts, Atomo nome, Escopo *escopo);
+
+/*
+ * iniciarTabelaLocal - Prepara uma tabela para os escopos de uma funcao,
+ * analisada em paralelo com as outras. Ela enxerga os simbolos que a
+ * envolvente ja tem agora.
+ */
+void iniciarTabelaLocal(TabelaSimbolos *ts, const TabelaSimbolos *envolvente);
+
+/*
+ * Move os simbolos (e a memoria) de uma tabela local para o fim de
+ * 'destino'; os escopos dela passam a ter ids depois dos de 'destino'
+ */
+void incorporarSimbolos(TabelaSimbolos *destino, TabelaSimbolos *origem);
 
-Simbolo* buscarSimboloNoEscopo(const char *nome, const char *escopo);
+unsigned int numeroDeSimbolos(const TabelaSimbolos *ts);
 
-void imprimirTabelaSimbolos(void);
+void imprimirTabelaSimbolos(const TabelaSimbolos *ts, const TabelaAtomos *atomos, Saida *saida);
 
-void liberarTabelaSimbolos(void);
+void liberarTabelaSimbolos(TabelaSimbolos *ts);
 
 #endif
@@ -0,0 +1,958 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ssa.h"
+#include "contexto.h"
+#include "paralelo.h"
+
+/* Capacidade inicial dos vetores que crescem */
+#define CAPACIDADE_INICIAL 64
+
+static void* alocarSSA(size_t bytes) {
+    void *p = malloc(bytes > 0 ? bytes : 1);
+    if (p == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a forma SSA\n");
+        exit(1);
+    }
+    return p;
+}
+
+/* Garante espaco para 'necessario' elementos, dobrando a capacidade */
+static void* crescerSSA(void *vetor, int *capacidade, int necessario, size_t tamanho) {
+    if (necessario <= *capacidade) return vetor;
+    while (*capacidade < necessario) {
+        *capacidade = *capacidade ? *capacidade * 2 : CAPACIDADE_INICIAL;
+    }
+    vetor = realloc(vetor, tamanho * (size_t) *capacidade);
+    if (vetor == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a forma SSA\n");
+        exit(1);
+    }
+    return vetor;
+}
+
+/* Vetor de 'n' inteiros com o mesmo valor */
+static int* vetorInteiros(int n, int valor) {
+    int *v = (int*) alocarSSA(sizeof(int) * (size_t) n);
+    for (int i = 0; i < n; i++) {
+        v[i] = valor;
+    }
+    return v;
+}
+
+/* Lista encadeada de inteiros por bloco, com os nos num vetor so */
+typedef struct {
+    int *valores;
+    int *proximos;
+    int total;
+    int capacidade;
+} ListasBloco;
+
+static void acrescentarLista(ListasBloco *l, int *primeiro, int *ultimo, int valor) {
+    l->valores = (int*) crescerSSA(l->valores, &l->capacidade, l->total + 1, sizeof(int));
+    l->proximos = (int*) realloc(l->proximos, sizeof(int) * (size_t) l->capacidade);
+    if (l->proximos == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a forma SSA\n");
+        exit(1);
+    }
+    l->valores[l->total] = valor;
+    l->proximos[l->total] = -1;
+    if (*primeiro < 0) {
+        *primeiro = l->total;
+    } else {
+        l->proximos[*ultimo] = l->total;
+    }
+    *ultimo = l->total++;
+}
+
+static void liberarListas(ListasBloco *l) {
+    free(l->valores);
+    free(l->proximos);
+}
+
+/* Locais da funcao: atomo -> indice denso, por enderecamento aberto */
+typedef struct {
+    Atomo *chaves;        /* ATOMO_NULO = livre */
+    int *indices;
+    unsigned int mascara;
+    int total;
+} MapaVariaveis;
+
+static void iniciarMapa(MapaVariaveis *m, int maximo) {
+    unsigned int capacidade = 16;
+    while (capacidade < (unsigned int) maximo * 2) {
+        capacidade *= 2;
+    }
+    m->chaves = (Atomo*) calloc(capacidade, sizeof(Atomo));
+    m->indices = (int*) alocarSSA(sizeof(int) * capacidade);
+    if (m->chaves == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a forma SSA\n");
+        exit(1);
+    }
+    m->mascara = capacidade - 1;
+    m->total = 0;
+}
+
+/* Indice da local (inserida se 'inserir'; senao -1 se nao existir) */
+static int indiceVariavel(MapaVariaveis *m, Atomo atomo, int inserir) {
+    unsigned int i = (atomo * 2654435761u) & m->mascara;
+    while (m->chaves[i] != ATOMO_NULO) {
+        if (m->chaves[i] == atomo) return m->indices[i];
+        i = (i + 1) & m->mascara;
+    }
+    if (!inserir) return -1;
+    m->chaves[i] = atomo;
+    m->indices[i] = m->total;
+    return m->total++;
+}
+
+static void liberarMapa(MapaVariaveis *m) {
+    free(m->chaves);
+    free(m->indices);
+}
+
+static Instrucao3Endereco* novaInstrucao(FuncaoSSA *f) {
+    f->instrucoes = (Instrucao3Endereco*) crescerSSA(f->instrucoes, &f->capacidadeInstrucoes,
+                                                     f->totalInstrucoes + 1, sizeof(Instrucao3Endereco));
+    return &f->instrucoes[f->totalInstrucoes++];
+}
+
+static int novoValor(FuncaoSSA *f, Atomo variavel, int numero, int definicao) {
+    f->valores = (ValorSSA*) crescerSSA(f->valores, &f->capacidadeValores, f->totalValores + 1,
+                                        sizeof(ValorSSA));
+    ValorSSA *v = &f->valores[f->totalValores];
+    v->variavel = variavel;
+    v->numero = numero;
+    v->definicao = definicao;
+    return f->totalValores++;
+}
+
+/* Primeira instrucao depois do rotulo do bloco (onde ficam os phis) */
+static int topoBloco(const FuncaoSSA *f, int b) {
+    int i = f->blocos[b].inicio;
+    if (i < f->blocos[b].fim && (Operador) f->instrucoes[i].operador == OP_ROTULO) {
+        i++;
+    }
+    return i;
+}
+
+/* Estado da construcao de uma funcao (liberado no fim) */
+typedef struct {
+    FuncaoSSA *f;
+    int *ordem;               /* Blocos alcancaveis em pos-ordem reversa */
+    int numAlcancaveis;
+    int *posOrdem;            /* Numero de pos-ordem (-1 = inalcancavel) */
+    int *idom;                /* Com a entrada apontando para si mesma */
+    MapaVariaveis mapa;
+    Atomo *atomos;            /* Atomo de cada local */
+    int *topo;                /* Versao atual de cada local (-1 = a da entrada) */
+    int *entrada;             /* Valor x.0 de cada local (-1 = ainda nao criado) */
+    int *versoes;             /* Proxima versao de cada local */
+    int *valorTemp;           /* Valor de cada temporario (pelo numero - menorTemp) */
+    int menorTemp;
+    int *historico;           /* Pares (local, versao anterior) para desfazer */
+    int totalHistorico;
+    int capacidadeHistorico;
+} ConstrucaoSSA;
+
+/*
+ * ordenarBlocos - Pos-ordem reversa dos blocos alcancaveis, com uma pilha
+ * explicita de (bloco, proximo sucessor)
+ */
+static void ordenarBlocos(ConstrucaoSSA *cs) {
+    const FuncaoSSA *f = cs->f;
+    int *pilhaBloco = vetorInteiros(f->numBlocos, 0);
+    int *pilhaSucessor = vetorInteiros(f->numBlocos, 0);
+    int *posOrdem = cs->posOrdem;
+    int *visitado = vetorInteiros(f->numBlocos, 0);
+    int topo = 0, numPos = 0;
+
+    pilhaBloco[0] = 0;
+    visitado[0] = 1;
+    while (topo >= 0) {
+        int b = pilhaBloco[topo];
+        if (pilhaSucessor[topo] < f->blocos[b].numSucessores) {
+            int s = f->blocos[b].sucessores[pilhaSucessor[topo]++];
+            if (!visitado[s]) {
+                visitado[s] = 1;
+                topo++;
+                pilhaBloco[topo] = s;
+                pilhaSucessor[topo] = 0;
+            }
+        } else {
+            posOrdem[b] = numPos;
+            cs->ordem[numPos++] = b;
+            topo--;
+        }
+    }
+
+    /* Inverte para a pos-ordem reversa */
+    for (int i = 0, j = numPos - 1; i < j; i++, j--) {
+        int t = cs->ordem[i];
+        cs->ordem[i] = cs->ordem[j];
+        cs->ordem[j] = t;
+    }
+    cs->numAlcancaveis = numPos;
+    free(pilhaBloco);
+    free(pilhaSucessor);
+    free(visitado);
+}
+
+/* Ancestral comum mais proximo na arvore de dominadores parcial */
+static int intersectar(const ConstrucaoSSA *cs, int b1, int b2) {
+    while (b1 != b2) {
+        while (cs->posOrdem[b1] < cs->posOrdem[b2]) b1 = cs->idom[b1];
+        while (cs->posOrdem[b2] < cs->posOrdem[b1]) b2 = cs->idom[b2];
+    }
+    return b1;
+}
+
+/*
+ * calcularDominadores - Algoritmo de Cooper, Harvey e Kennedy: percorre os
+ * blocos em pos-ordem reversa ate os dominadores imediatos pararem de mudar
+ */
+static void calcularDominadores(ConstrucaoSSA *cs) {
+    const FuncaoSSA *f = cs->f;
+    int mudou = 1;
+    cs->idom[0] = 0;
+
+    while (mudou) {
+        mudou = 0;
+        for (int i = 1; i < cs->numAlcancaveis; i++) {
+            int b = cs->ordem[i];
+            const BlocoBasico *bloco = &f->blocos[b];
+            int novo = -1;
+            for (int k = 0; k < bloco->numPredecessores; k++) {
+                int p = f->predecessores[bloco->primeiroPredecessor + k];
+                if (cs->idom[p] < 0) continue;
+                novo = novo < 0 ? p : intersectar(cs, novo, p);
+            }
+            if (cs->idom[b] != novo) {
+                cs->idom[b] = novo;
+                mudou = 1;
+            }
+        }
+    }
+}
+
+/*
+ * calcularFronteiras - Fronteira de dominancia de cada bloco: de cada
+ * predecessor de uma juncao, sobe pelos dominadores ate o da juncao
+ */
+static void calcularFronteiras(const ConstrucaoSSA *cs, ListasBloco *fronteiras, int *primeira) {
+    const FuncaoSSA *f = cs->f;
+    int *ultima = vetorInteiros(f->numBlocos, -1);
+    int *ultimaJuncao = vetorInteiros(f->numBlocos, -1);
+
+    for (int i = 0; i < cs->numAlcancaveis; i++) {
+        int b = cs->ordem[i];
+        const BlocoBasico *bloco = &f->blocos[b];
+        if (bloco->numPredecessores < 2) continue;
+
+        for (int k = 0; k < bloco->numPredecessores; k++) {
+            int corredor = f->predecessores[bloco->primeiroPredecessor + k];
+            if (cs->idom[corredor] < 0) continue;
+            while (corredor != cs->idom[b]) {
+                if (ultimaJuncao[corredor] != b) {
+                    ultimaJuncao[corredor] = b;
+                    acrescentarLista(fronteiras, &primeira[corredor], &ultima[corredor], b);
+                }
+                corredor = cs->idom[corredor];
+            }
+        }
+    }
+    free(ultima);
+    free(ultimaJuncao);
+}
+
+/*
+ * posicionarPhis - Semi-podado: so as locais usadas num bloco antes de
+ * serem definidas nele ganham phis, nas fronteiras iteradas das definicoes
+ */
+static void posicionarPhis(ConstrucaoSSA *cs, const Instrucao3Endereco *codigo, const BlocoBasico *blocos,
+                           const ListasBloco *fronteiras, const int *primeiraFronteira,
+                           ListasBloco *phis, int *primeiroPhi, int *ultimoPhi) {
+    const FuncaoSSA *f = cs->f;
+    int nv = cs->mapa.total;
+    int *global = vetorInteiros(nv, 0);
+    int *definidaEm = vetorInteiros(nv, -1);
+    ListasBloco definicoes = { NULL, NULL, 0, 0 };
+    int *primeiraDef = vetorInteiros(nv, -1);
+    int *ultimaDef = vetorInteiros(nv, -1);
+
+    for (int i = 0; i < cs->numAlcancaveis; i++) {
+        int b = cs->ordem[i];
+        for (int k = blocos[b].inicio; k < blocos[b].fim; k++) {
+            const Instrucao3Endereco *inst = &codigo[k];
+            for (int pos = OPERANDO1; pos <= OPERANDO2; pos++) {
+                if (inst->tipos[pos] != OPERANDO_LOCAL) continue;
+                int v = indiceVariavel(&cs->mapa, (Atomo) inst->valores[pos], 0);
+                if (definidaEm[v] != b) global[v] = 1;
+            }
+            if (inst->tipos[RESULTADO] == OPERANDO_LOCAL) {
+                int v = indiceVariavel(&cs->mapa, (Atomo) inst->valores[RESULTADO], 0);
+                if (definidaEm[v] != b) {
+                    definidaEm[v] = b;
+                    acrescentarLista(&definicoes, &primeiraDef[v], &ultimaDef[v], b);
+                }
+            }
+        }
+    }
+
+    int *temPhi = vetorInteiros(f->numBlocos, -1);
+    int *naLista = vetorInteiros(f->numBlocos, -1);
+    int *lista = vetorInteiros(f->numBlocos, 0);
+    for (int v = 0; v < nv; v++) {
+        if (!global[v]) continue;
+
+        int n = 0;
+        for (int d = primeiraDef[v]; d >= 0; d = definicoes.proximos[d]) {
+            lista[n++] = definicoes.valores[d];
+            naLista[definicoes.valores[d]] = v;
+        }
+        while (n > 0) {
+            int b = lista[--n];
+            for (int y = primeiraFronteira[b]; y >= 0; y = fronteiras->proximos[y]) {
+                int juncao = fronteiras->valores[y];
+                if (temPhi[juncao] == v) continue;
+                temPhi[juncao] = v;
+                acrescentarLista(phis, &primeiroPhi[juncao], &ultimoPhi[juncao], v);
+                if (naLista[juncao] != v) {
+                    naLista[juncao] = v;
+                    lista[n++] = juncao;
+                }
+            }
+        }
+    }
+
+    free(global);
+    free(definidaEm);
+    liberarListas(&definicoes);
+    free(primeiraDef);
+    free(ultimaDef);
+    free(temPhi);
+    free(naLista);
+    free(lista);
+}
+
+/* Valor atual da local v (x.0, criado na primeira vez, se nao houver) */
+static int valorAtual(ConstrucaoSSA *cs, int v) {
+    if (cs->topo[v] >= 0) return cs->topo[v];
+    if (cs->entrada[v] < 0) {
+        cs->entrada[v] = novoValor(cs->f, cs->atomos[v], 0, -1);
+    }
+    return cs->entrada[v];
+}
+
+/* Nova versao da local v, definida na instrucao 'definicao' */
+static int novaVersao(ConstrucaoSSA *cs, int v, int definicao) {
+    cs->historico = (int*) crescerSSA(cs->historico, &cs->capacidadeHistorico,
+                                      cs->totalHistorico + 2, sizeof(int));
+    cs->historico[cs->totalHistorico++] = v;
+    cs->historico[cs->totalHistorico++] = cs->topo[v];
+    cs->topo[v] = novoValor(cs->f, cs->atomos[v], cs->versoes[v]++, definicao);
+    return cs->topo[v];
+}
+
+/* Local de um phi (ainda com o atomo ou ja renomeado) */
+static int variavelPhi(ConstrucaoSSA *cs, const Instrucao3Endereco *inst) {
+    Atomo atomo = inst->tipos[RESULTADO] == OPERANDO_VALOR
+                ? cs->f->valores[inst->valores[RESULTADO]].variavel
+                : (Atomo) inst->valores[RESULTADO];
+    return indiceVariavel(&cs->mapa, atomo, 0);
+}
+
+/*
+ * renomearBloco - Troca usos e definicoes do bloco por valores e preenche,
+ * nos phis dos sucessores, o argumento que vem deste bloco
+ */
+static void renomearBloco(ConstrucaoSSA *cs, int b) {
+    FuncaoSSA *f = cs->f;
+
+    for (int i = f->blocos[b].inicio; i < f->blocos[b].fim; i++) {
+        Instrucao3Endereco *inst = &f->instrucoes[i];
+        if ((Operador) inst->operador == OP_PHI) {
+            inst->valores[RESULTADO] = novaVersao(cs, variavelPhi(cs, inst), i);
+            inst->tipos[RESULTADO] = OPERANDO_VALOR;
+            continue;
+        }
+
+        for (int pos = OPERANDO1; pos <= OPERANDO2; pos++) {
+            if (inst->tipos[pos] == OPERANDO_LOCAL) {
+                int v = indiceVariavel(&cs->mapa, (Atomo) inst->valores[pos], 0);
+                inst->valores[pos] = valorAtual(cs, v);
+                inst->tipos[pos] = OPERANDO_VALOR;
+            } else if (inst->tipos[pos] == OPERANDO_TEMP) {
+                int *valor = &cs->valorTemp[inst->valores[pos] - cs->menorTemp];
+                if (*valor < 0) {
+                    *valor = novoValor(f, ATOMO_NULO, inst->valores[pos], -1);
+                }
+                inst->valores[pos] = *valor;
+                inst->tipos[pos] = OPERANDO_VALOR;
+            }
+        }
+
+        if (inst->tipos[RESULTADO] == OPERANDO_LOCAL) {
+            int v = indiceVariavel(&cs->mapa, (Atomo) inst->valores[RESULTADO], 0);
+            inst->valores[RESULTADO] = novaVersao(cs, v, i);
+            inst->tipos[RESULTADO] = OPERANDO_VALOR;
+        } else if (inst->tipos[RESULTADO] == OPERANDO_TEMP) {
+            int valor = novoValor(f, ATOMO_NULO, inst->valores[RESULTADO], i);
+            cs->valorTemp[inst->valores[RESULTADO] - cs->menorTemp] = valor;
+            inst->valores[RESULTADO] = valor;
+            inst->tipos[RESULTADO] = OPERANDO_VALOR;
+        }
+    }
+
+    for (int k = 0; k < f->blocos[b].numSucessores; k++) {
+        int s = f->blocos[b].sucessores[k];
+        const BlocoBasico *sucessor = &f->blocos[s];
+        int j = 0;
+        while (f->predecessores[sucessor->primeiroPredecessor + j] != b) {
+            j++;
+        }
+        for (int i = topoBloco(f, s); i < sucessor->fim; i++) {
+            Instrucao3Endereco *phi = &f->instrucoes[i];
+            if ((Operador) phi->operador != OP_PHI) break;
+            Operando *arg = &f->argumentosPhi[phi->valores[OPERANDO1] + j];
+            arg->tipo = OPERANDO_VALOR;
+            arg->valor = valorAtual(cs, variavelPhi(cs, phi));
+        }
+    }
+}
+
+/*
+ * renomear - Percorre a arvore de dominadores em pre-ordem com uma pilha
+ * explicita; na saida de cada bloco, desfaz as versoes que ele empilhou
+ */
+static void renomear(ConstrucaoSSA *cs) {
+    const FuncaoSSA *f = cs->f;
+    int nb = f->numBlocos;
+
+    /* Filhos de cada bloco na arvore de dominadores, num vetor so */
+    int *primeiroFilho = vetorInteiros(nb + 1, 0);
+    int *filhos = vetorInteiros(nb, 0);
+    for (int b = 1; b < nb; b++) {
+        if (cs->idom[b] >= 0) primeiroFilho[cs->idom[b] + 1]++;
+    }
+    for (int b = 0; b < nb; b++) {
+        primeiroFilho[b + 1] += primeiroFilho[b];
+    }
+    int *preenchidos = vetorInteiros(nb, 0);
+    for (int b = 1; b < nb; b++) {
+        if (cs->idom[b] < 0) continue;
+        int pai = cs->idom[b];
+        filhos[primeiroFilho[pai] + preenchidos[pai]++] = b;
+    }
+    free(preenchidos);
+
+    /* Quadros (bloco, marca do historico); marca -1 = entrando no bloco */
+    int *pilhaBloco = vetorInteiros(2 * nb, 0);
+    int *pilhaMarca = vetorInteiros(2 * nb, 0);
+    int topo = 1;
+    pilhaBloco[0] = 0;
+    pilhaMarca[0] = -1;
+    while (topo > 0) {
+        topo--;
+        int b = pilhaBloco[topo];
+        int marca = pilhaMarca[topo];
+        if (marca >= 0) {
+            while (cs->totalHistorico > marca) {
+                cs->totalHistorico -= 2;
+                cs->topo[cs->historico[cs->totalHistorico]] = cs->historico[cs->totalHistorico + 1];
+            }
+            continue;
+        }
+
+        /* O quadro de saida fica embaixo dos filhos */
+        pilhaMarca[topo++] = cs->totalHistorico;
+        renomearBloco(cs, b);
+        for (int k = primeiroFilho[b + 1] - 1; k >= primeiroFilho[b]; k--) {
+            pilhaBloco[topo] = filhos[k];
+            pilhaMarca[topo++] = -1;
+        }
+    }
+
+    free(primeiroFilho);
+    free(filhos);
+    free(pilhaBloco);
+    free(pilhaMarca);
+}
+
+/*
+ * copiarComPhis - Monta o vetor de instrucoes da funcao: o codigo de cada
+ * bloco com os seus phis logo depois do rotulo (argumentos ainda vazios)
+ */
+static void copiarComPhis(ConstrucaoSSA *cs, const CodigoIntermediario *c, const FuncaoFluxo *ff,
+                          const BlocoBasico *originais, const ListasBloco *phis, const int *primeiroPhi) {
+    FuncaoSSA *f = cs->f;
+    const Instrucao3Endereco *codigo = c->instrucoes;
+
+    /* Um argumento por predecessor de cada phi, reservados de uma vez */
+    int argumentos = 0;
+    for (int b = 0; b < f->numBlocos; b++) {
+        for (int p = primeiroPhi[b]; p >= 0; p = phis->proximos[p]) {
+            argumentos += f->blocos[b].numPredecessores;
+        }
+    }
+    f->argumentosPhi = (Operando*) alocarSSA(sizeof(Operando) * (size_t) argumentos);
+
+    *novaInstrucao(f) = codigo[ff->instrucaoFuncao];
+    for (int b = 0; b < f->numBlocos; b++) {
+        int i = originais[b].inicio;
+        f->blocos[b].inicio = f->totalInstrucoes;
+        if (i < originais[b].fim && (Operador) codigo[i].operador == OP_ROTULO) {
+            *novaInstrucao(f) = codigo[i++];
+        }
+
+        for (int p = primeiroPhi[b]; p >= 0; p = phis->proximos[p]) {
+            int n = f->blocos[b].numPredecessores;
+            Instrucao3Endereco *phi = novaInstrucao(f);
+            phi->operador = (unsigned char) OP_PHI;
+            phi->tipos[OPERANDO1] = phi->tipos[OPERANDO2] = (unsigned char) OPERANDO_NENHUM;
+            phi->valores[OPERANDO1] = f->totalArgumentosPhi;
+            phi->valores[OPERANDO2] = n;
+            phi->tipos[RESULTADO] = (unsigned char) OPERANDO_LOCAL;
+            phi->valores[RESULTADO] = (int) cs->atomos[phis->valores[p]];
+
+            for (int k = 0; k < n; k++) {
+                f->argumentosPhi[f->totalArgumentosPhi].tipo = OPERANDO_NENHUM;
+                f->argumentosPhi[f->totalArgumentosPhi++].valor = 0;
+            }
+            f->numPhis++;
+        }
+
+        for (; i < originais[b].fim; i++) {
+            *novaInstrucao(f) = codigo[i];
+        }
+        f->blocos[b].fim = f->totalInstrucoes;
+    }
+    *novaInstrucao(f) = codigo[ff->instrucaoFim];
+}
+
+/* Dados compartilhados (so leitura) pelas tarefas */
+typedef struct {
+    const CodigoIntermediario *codigo;
+    const GrafoFluxo *grafo;
+    FuncaoSSA *funcoes;
+} TarefaSSA;
+
+/* Tarefa paralela: converte a k-esima funcao */
+static void construirFuncaoSSA(void *dados, int k) {
+    const TarefaSSA *t = (const TarefaSSA*) dados;
+    const GrafoFluxo *g = t->grafo;
+    const FuncaoFluxo *ff = &g->funcoes[k];
+    const Instrucao3Endereco *codigo = t->codigo->instrucoes;
+    FuncaoSSA *f = &t->funcoes[k];
+    int nb = ff->numBlocos;
+    int base = ff->primeiroBloco;
+
+    /* Blocos e arestas com indices locais (os da funcao sao contiguos) */
+    f->nome = ff->nome;
+    f->numBlocos = nb;
+    f->blocos = (BlocoBasico*) alocarSSA(sizeof(BlocoBasico) * (size_t) nb);
+    int primeiraAresta = g->blocos[base].primeiroPredecessor;
+    int arestas = 0;
+    for (int b = 0; b < nb; b++) {
+        BlocoBasico bloco = g->blocos[base + b];
+        for (int s = 0; s < bloco.numSucessores; s++) {
+            bloco.sucessores[s] -= base;
+        }
+        bloco.primeiroPredecessor -= primeiraAresta;
+        arestas += bloco.numPredecessores;
+        f->blocos[b] = bloco;
+    }
+    f->predecessores = (int*) alocarSSA(sizeof(int) * (size_t) arestas);
+    for (int i = 0; i < arestas; i++) {
+        f->predecessores[i] = g->predecessores[primeiraAresta + i] - base;
+    }
+
+    ConstrucaoSSA cs;
+    cs.f = f;
+    cs.ordem = vetorInteiros(nb, 0);
+    cs.posOrdem = vetorInteiros(nb, -1);
+    cs.idom = vetorInteiros(nb, -1);
+    cs.historico = NULL;
+    cs.totalHistorico = 0;
+    cs.capacidadeHistorico = 0;
+    ordenarBlocos(&cs);
+    calcularDominadores(&cs);
+
+    /* Locais e faixa de temporarios dos blocos alcancaveis */
+    int ocorrencias = 0;
+    int menorTemp = 0, maiorTemp = -1;
+    for (int i = 0; i < cs.numAlcancaveis; i++) {
+        const BlocoBasico *bloco = &g->blocos[base + cs.ordem[i]];
+        for (int k = bloco->inicio; k < bloco->fim; k++) {
+            for (int pos = OPERANDO1; pos <= RESULTADO; pos++) {
+                if (codigo[k].tipos[pos] == OPERANDO_LOCAL) {
+                    ocorrencias++;
+                } else if (codigo[k].tipos[pos] == OPERANDO_TEMP) {
+                    int n = codigo[k].valores[pos];
+                    if (maiorTemp < menorTemp) menorTemp = maiorTemp = n;
+                    if (n < menorTemp) menorTemp = n;
+                    if (n > maiorTemp) maiorTemp = n;
+                }
+            }
+        }
+    }
+    iniciarMapa(&cs.mapa, ocorrencias);
+    for (int i = 0; i < cs.numAlcancaveis; i++) {
+        const BlocoBasico *bloco = &g->blocos[base + cs.ordem[i]];
+        for (int k = bloco->inicio; k < bloco->fim; k++) {
+            for (int pos = OPERANDO1; pos <= RESULTADO; pos++) {
+                if (codigo[k].tipos[pos] == OPERANDO_LOCAL) {
+                    indiceVariavel(&cs.mapa, (Atomo) codigo[k].valores[pos], 1);
+                }
+            }
+        }
+    }
+    int nv = cs.mapa.total;
+    cs.atomos = (Atomo*) alocarSSA(sizeof(Atomo) * (size_t) nv);
+    for (unsigned int i = 0; i <= cs.mapa.mascara; i++) {
+        if (cs.mapa.chaves[i] != ATOMO_NULO) {
+            cs.atomos[cs.mapa.indices[i]] = cs.mapa.chaves[i];
+        }
+    }
+
+    /* Fronteiras e phis; depois o codigo com os phis, ja nos blocos locais */
+    ListasBloco fronteiras = { NULL, NULL, 0, 0 };
+    ListasBloco phis = { NULL, NULL, 0, 0 };
+    int *primeiraFronteira = vetorInteiros(nb, -1);
+    int *primeiroPhi = vetorInteiros(nb, -1);
+    int *ultimoPhi = vetorInteiros(nb, -1);
+    calcularFronteiras(&cs, &fronteiras, primeiraFronteira);
+
+    posicionarPhis(&cs, codigo, &g->blocos[base], &fronteiras, primeiraFronteira,
+                   &phis, primeiroPhi, ultimoPhi);
+
+    copiarComPhis(&cs, t->codigo, ff, &g->blocos[base], &phis, primeiroPhi);
+
+    cs.topo = vetorInteiros(nv, -1);
+    cs.entrada = vetorInteiros(nv, -1);
+    cs.versoes = vetorInteiros(nv, 1);
+    cs.menorTemp = menorTemp;
+    cs.valorTemp = vetorInteiros(maiorTemp - menorTemp + 1, -1);
+    renomear(&cs);
+
+    /* A entrada nao tem dominador imediato */
+    cs.idom[0] = -1;
+    f->idom = cs.idom;
+    f->blocoFluxo = vetorInteiros(nb, 0);
+
+    free(cs.ordem);
+    free(cs.posOrdem);
+    liberarMapa(&cs.mapa);
+    free(cs.atomos);
+    free(cs.topo);
+    free(cs.entrada);
+    free(cs.versoes);
+    free(cs.valorTemp);
+    free(cs.historico);
+    liberarListas(&fronteiras);
+    liberarListas(&phis);
+    free(primeiraFronteira);
+    free(primeiroPhi);
+    free(ultimoPhi);
+}
+
+int construirSSA(ContextoCompilador *ctx) {
+    FormaSSA *ssa = &ctx->ssa;
+    liberarSSA(ssa);
+
+    ssa->totalFuncoes = ctx->fluxo.totalFuncoes;
+    ssa->funcoes = (FuncaoSSA*) calloc((size_t) (ssa->totalFuncoes > 0 ? ssa->totalFuncoes : 1),
+                                       sizeof(FuncaoSSA));
+    if (ssa->funcoes == NULL) {
+        fprintf(stderr, "Erro de alocacao de memoria para a forma SSA\n");
+        exit(1);
+    }
+    ssa->contadorTemp = ctx->codigo.contadorTemp;
+    ssa->contadorRotulos = ctx->codigo.contadorRotulos;
+
+    TarefaSSA tarefa = { &ctx->codigo, &ctx->fluxo, ssa->funcoes };
+    executarEmParalelo(ssa->totalFuncoes, ctx->numThreads, construirFuncaoSSA, &tarefa);
+
+    int phis = 0;
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        phis += ssa->funcoes[k].numPhis;
+    }
+    return phis;
+}
+
+/* Operando de volta ao codigo comum: versao -> local, valor -> temporario */
+static Operando operandoComum(const FuncaoSSA *f, int tipo, int valor) {
+    Operando op;
+    op.tipo = (TipoOperando) tipo;
+    op.valor = valor;
+    if (tipo == OPERANDO_VALOR) {
+        const ValorSSA *v = &f->valores[valor];
+        op.tipo = v->variavel != ATOMO_NULO ? OPERANDO_LOCAL : OPERANDO_TEMP;
+        op.valor = v->variavel != ATOMO_NULO ? (int) v->variavel : v->numero;
+    }
+    return op;
+}
+
+static void acrescentarInstrucao(CodigoIntermediario *c, Instrucao3Endereco inst) {
+    c->instrucoes = (Instrucao3Endereco*) crescerSSA(c->instrucoes, &c->capacidadeInstrucoes,
+                                                     c->totalInstrucoes + 1, sizeof(Instrucao3Endereco));
+    c->instrucoes[c->totalInstrucoes++] = inst;
+}
+
+/* Copias que os phis dos sucessores pedem no fim do bloco b */
+static void copiasDosPhis(CodigoIntermediario *c, const FuncaoSSA *f, int b) {
+    for (int k = 0; k < f->blocos[b].numSucessores; k++) {
+        int s = f->blocos[b].sucessores[k];
+        const BlocoBasico *sucessor = &f->blocos[s];
+        int j = 0;
+        while (f->predecessores[sucessor->primeiroPredecessor + j] != b) {
+            j++;
+        }
+
+        for (int i = topoBloco(f, s); i < sucessor->fim; i++) {
+            const Instrucao3Endereco *phi = &f->instrucoes[i];
+            if ((Operador) phi->operador != OP_PHI) break;
+            Atomo variavel = f->valores[phi->valores[RESULTADO]].variavel;
+            Operando arg = f->argumentosPhi[phi->valores[OPERANDO1] + j];
+
+            /* Versao da mesma local (ou aresta inalcancavel): nada a copiar */
+            if (arg.tipo == OPERANDO_NENHUM) continue;
+            if (arg.tipo == OPERANDO_VALOR && f->valores[arg.valor].variavel == variavel) continue;
+
+            Operando origem = operandoComum(f, arg.tipo, arg.valor);
+            Instrucao3Endereco copia;
+            copia.operador = (unsigned char) OP_ATRIB;
+            copia.tipos[OPERANDO1] = (unsigned char) origem.tipo;
+            copia.valores[OPERANDO1] = origem.valor;
+            copia.tipos[OPERANDO2] = (unsigned char) OPERANDO_NENHUM;
+            copia.valores[OPERANDO2] = 0;
+            copia.tipos[RESULTADO] = (unsigned char) OPERANDO_LOCAL;
+            copia.valores[RESULTADO] = (int) variavel;
+            acrescentarInstrucao(c, copia);
+        }
+    }
+}
+
+/*
+ * numerarBlocos - Troca a posicao de cada bloco no codigo novo pelo bloco
+ * do grafo refeito que a contem. A entrada vai para a entrada; um bloco
+ * que ficou vazio leva o numero do bloco onde o codigo segue.
+ */
+static void numerarBlocos(FormaSSA *ssa, const GrafoFluxo *g) {
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        FuncaoSSA *f = &ssa->funcoes[k];
+        const FuncaoFluxo *ff = &g->funcoes[k];
+        int ultimo = ff->primeiroBloco + ff->numBlocos - 1;
+        int atual = ff->primeiroBloco;
+        f->blocoFluxo[0] = atual;
+        for (int b = 1; b < f->numBlocos; b++) {
+            if (f->blocoFluxo[b] < 0) continue;
+            while (atual < ultimo && g->blocos[atual].fim <= f->blocoFluxo[b]) {
+                atual++;
+            }
+            f->blocoFluxo[b] = atual;
+        }
+    }
+}
+
+void sairSSA(ContextoCompilador *ctx) {
+    FormaSSA *ssa = &ctx->ssa;
+    CodigoIntermediario c = CODIGO_INTERMEDIARIO_INICIAL;
+    c.contadorTemp = ssa->contadorTemp;
+    c.contadorRotulos = ssa->contadorRotulos;
+
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        const FuncaoSSA *f = &ssa->funcoes[k];
+        acrescentarInstrucao(&c, f->instrucoes[0]);
+
+        for (int b = 0; b < f->numBlocos; b++) {
+            const BlocoBasico *bloco = &f->blocos[b];
+
+            /* Por enquanto, onde o bloco comeca no codigo novo */
+            if (f->blocoFluxo[b] >= 0) f->blocoFluxo[b] = c.totalInstrucoes;
+
+            /* As copias entram antes do desvio que fecha o bloco */
+            int fimCorpo = bloco->fim;
+            if (fimCorpo > bloco->inicio) {
+                Operador ultimo = (Operador) f->instrucoes[fimCorpo - 1].operador;
+                if (ultimo == OP_DESVIO || ultimo == OP_SE_FALSO) fimCorpo--;
+            }
+
+            for (int i = bloco->inicio; i < bloco->fim; i++) {
+                if (i == fimCorpo) {
+                    copiasDosPhis(&c, f, b);
+                }
+                Instrucao3Endereco inst = f->instrucoes[i];
+                if ((Operador) inst.operador == OP_PHI) continue;
+                for (int pos = OPERANDO1; pos <= RESULTADO; pos++) {
+                    Operando op = operandoComum(f, inst.tipos[pos], inst.valores[pos]);
+                    inst.tipos[pos] = (unsigned char) op.tipo;
+                    inst.valores[pos] = op.valor;
+                }
+                acrescentarInstrucao(&c, inst);
+            }
+            if (fimCorpo == bloco->fim) {
+                copiasDosPhis(&c, f, b);
+            }
+        }
+        acrescentarInstrucao(&c, f->instrucoes[f->totalInstrucoes - 1]);
+    }
+
+    /* O codigo sem SSA substitui o original, com um grafo novo */
+    liberarCodigoIntermediario(ctx);
+    ctx->codigo = c;
+    liberarGrafoFluxo(&ctx->fluxo);
+    construirGrafoFluxo(&ctx->fluxo, &ctx->codigo);
+    numerarBlocos(ssa, &ctx->fluxo);
+}
+
+/*
+ * escreverOperandoSSA - Escreve um operando da forma SSA (x.2, t5, 42,
+ * nome, L3 ou nada) e devolve quantos caracteres ele ocupou
+ */
+static int escreverOperandoSSA(Saida *saida, const FuncaoSSA *f, const TabelaAtomos *atomos,
+                               Operando op) {
+    const char *nome;
+    int numero;
+    switch (op.tipo) {
+    case OPERANDO_VALOR: {
+        const ValorSSA *v = &f->valores[op.valor];
+        if (v->variavel == ATOMO_NULO) {
+            saidaCaractere(saida, 't');
+            saidaInteiro(saida, v->numero);
+            return 1 + saidaLarguraInteiro(v->numero);
+        }
+        nome = nomeAtomo(atomos, v->variavel);
+        saidaTexto(saida, nome);
+        saidaCaractere(saida, '.');
+        saidaInteiro(saida, v->numero);
+        return (int) strlen(nome) + 1 + saidaLarguraInteiro(v->numero);
+    }
+    case OPERANDO_TEMP:
+    case OPERANDO_ROTULO:
+        numero = op.valor;
+        saidaCaractere(saida, op.tipo == OPERANDO_TEMP ? 't' : 'L');
+        saidaInteiro(saida, numero);
+        return 1 + saidaLarguraInteiro(numero);
+    case OPERANDO_IMEDIATO:
+        saidaInteiro(saida, op.valor);
+        return saidaLarguraInteiro(op.valor);
+    case OPERANDO_VARIAVEL:
+    case OPERANDO_LOCAL:
+        nome = nomeAtomo(atomos, (Atomo) op.valor);
+        saidaTexto(saida, nome);
+        return (int) strlen(nome);
+    default:
+        return 0;
+    }
+}
+
+static void imprimirOperandoSSA(Saida *saida, const FuncaoSSA *f, const TabelaAtomos *atomos,
+                                Operando op, int largura) {
+    int n = escreverOperandoSSA(saida, f, atomos, op);
+    if (n < largura) {
+        saidaEspacos(saida, (size_t) (largura - n));
+    }
+}
+
+/* Argumentos do phi separados por virgula, ocupando as duas colunas de operandos */
+static void imprimirArgumentosPhi(Saida *saida, const FuncaoSSA *f, const TabelaAtomos *atomos,
+                                  const Instrucao3Endereco *phi) {
+    int largura = 0;
+    for (int k = 0; k < phi->valores[OPERANDO2]; k++) {
+        Operando arg = f->argumentosPhi[phi->valores[OPERANDO1] + k];
+        if (k > 0) {
+            saidaTexto(saida, ", ");
+            largura += 2;
+        }
+        if (arg.tipo == OPERANDO_NENHUM) {
+            saidaCaractere(saida, '?');
+            largura++;
+            continue;
+        }
+        largura += escreverOperandoSSA(saida, f, atomos, arg);
+    }
+    if (largura < 31) {
+        saidaEspacos(saida, (size_t) (31 - largura));
+    }
+}
+
+void imprimirSSA(const FormaSSA *ssa, const TabelaAtomos *atomos, Saida *saida) {
+    saidaTexto(saida, "\n");
+    saidaTexto(saida, "================================================================================\n");
+    saidaTexto(saida, "                                   FORMA SSA                                    \n");
+    saidaTexto(saida, "================================================================================\n");
+
+    /* Blocos numerados como no grafo refeito por sairSSA; os que a propagacao
+       de constantes removeu ficam sem numero */
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        const FuncaoSSA *f = &ssa->funcoes[k];
+        saidaTexto(saida, "Funcao ");
+        saidaTexto(saida, nomeAtomo(atomos, f->nome));
+        saidaTexto(saida, ": ");
+        saidaInteiro(saida, f->numPhis);
+        saidaTexto(saida, f->numPhis == 1 ? " phi, " : " phis, ");
+        saidaInteiro(saida, f->totalValores);
+        saidaTexto(saida, f->totalValores == 1 ? " valor\n" : " valores\n");
+        saidaTexto(saida, "Num      Op         Operando1       Operando2       Resultado      \n");
+        saidaTexto(saida, "--------------------------------------------------------------------------------\n");
+
+        for (int b = 0; b < f->numBlocos; b++) {
+            saidaCaractere(saida, 'B');
+            if (f->blocoFluxo[b] < 0) {
+                saidaTexto(saida, "- (removido)\n");
+                continue;
+            }
+            saidaInteiro(saida, f->blocoFluxo[b]);
+            if (b == 0) {
+                saidaTexto(saida, " (entrada)\n");
+            } else if (f->idom[b] < 0) {
+                saidaTexto(saida, " (inalcancavel)\n");
+            } else {
+                saidaTexto(saida, " (idom B");
+                saidaInteiro(saida, f->blocoFluxo[f->idom[b]]);
+                saidaTexto(saida, ")\n");
+            }
+
+            /* Campos alinhados como "%-8d %-10s %-15s %-15s %-15s" */
+            for (int i = f->blocos[b].inicio; i < f->blocos[b].fim; i++) {
+                const Instrucao3Endereco *inst = &f->instrucoes[i];
+                saidaCampoInteiro(saida, i, 8);
+                saidaCaractere(saida, ' ');
+                saidaCampo(saida, nomeOperador((Operador) inst->operador), 10);
+                saidaCaractere(saida, ' ');
+                if ((Operador) inst->operador == OP_PHI) {
+                    imprimirArgumentosPhi(saida, f, atomos, inst);
+                } else {
+                    imprimirOperandoSSA(saida, f, atomos, operandoInstrucao(inst, OPERANDO1), 15);
+                    saidaCaractere(saida, ' ');
+                    imprimirOperandoSSA(saida, f, atomos, operandoInstrucao(inst, OPERANDO2), 15);
+                }
+                saidaCaractere(saida, ' ');
+                imprimirOperandoSSA(saida, f, atomos, operandoInstrucao(inst, RESULTADO), 15);
+                saidaCaractere(saida, '\n');
+            }
+        }
+        saidaTexto(saida, "\n");
+    }
+
+    saidaTexto(saida, "================================================================================\n");
+}
+
+/*
+ * liberarSSA - Libera memoria alocada
+ */
+void liberarSSA(FormaSSA *ssa) {
+    FormaSSA vazia = FORMA_SSA_INICIAL;
+    for (int k = 0; k < ssa->totalFuncoes; k++) {
+        FuncaoSSA *f = &ssa->funcoes[k];
+        free(f->instrucoes);
+        free(f->blocos);
+        free(f->predecessores);
+        free(f->idom);
+        free(f->blocoFluxo);
+        free(f->valores);
+        free(f->argumentosPhi);
+    }
+    free(ssa->funcoes);
+    *ssa = vazia;
+}
@@ -0,0 +1,80 @@
+#ifndef SSA_H
+#define SSA_H
+#include "atomos.h"
+#include "intermediario.h"
+#include "fluxo.h"
+#include "saida.h"
+
+/*
+ * Valor da forma SSA: uma versao de local (x.0 e o valor na entrada da
+ * funcao, parametro ou nao inicializado) ou um temporario, que ja tem uma
+ * so definicao. Os operandos OPERANDO_VALOR guardam o indice do valor.
+ */
+typedef struct {
+    Atomo variavel;       /* Local de origem (ATOMO_NULO = temporario) */
+    int numero;           /* Versao da local ou numero do temporario */
+    int definicao;        /* Instrucao que o define (-1 = entrada da funcao) */
+} ValorSSA;
+
+/*
+ * Uma funcao em SSA. As instrucoes vao do func ao endfunc, com os blocos
+ * na ordem do codigo e os phis no topo de cada bloco (depois do rotulo).
+ * Os blocos usam indices locais, na mesma ordem do grafo de fluxo; os
+ * inalcancaveis ficam com o codigo original, sem valores.
+ */
+typedef struct {
+    Atomo nome;
+    Instrucao3Endereco *instrucoes;
+    int totalInstrucoes;
+    int capacidadeInstrucoes;
+    BlocoBasico *blocos;      /* Faixas em 'instrucoes'; o bloco 0 e a entrada */
+    int numBlocos;
+    int *predecessores;       /* Arestas de chegada, agrupadas por bloco */
+    int *idom;                /* Dominador imediato (-1 = entrada ou inalcancavel) */
+    int *blocoFluxo;          /* Bloco do grafo refeito por sairSSA (-1 = removido) */
+    ValorSSA *valores;
+    int totalValores;
+    int capacidadeValores;
+    Operando *argumentosPhi;  /* Um por predecessor, na ordem de 'predecessores' */
+    int totalArgumentosPhi;
+    int numPhis;
+} FuncaoSSA;
+
+/* Programa em SSA: uma entrada por funcao, na ordem do fonte */
+typedef struct {
+    FuncaoSSA *funcoes;
+    int totalFuncoes;
+    int contadorTemp;         /* Do codigo de origem, para a volta */
+    int contadorRotulos;
+} FormaSSA;
+
+/* Forma vazia, pronta para uso */
+#define FORMA_SSA_INICIAL { NULL, 0, 0, 0 }
+
+struct ContextoCompilador;
+
+/*
+ * construirSSA - Converte o codigo do contexto (com o grafo de fluxo ja
+ * construido) para SSA, uma funcao por tarefa: dominadores pelo algoritmo
+ * de Cooper, Harvey e Kennedy, fronteiras de dominancia, phis so para as
+ * locais vivas entre blocos e renomeacao pela arvore de dominadores.
+ * Devolve o total de phis.
+ */
+int construirSSA(struct ContextoCompilador *ctx);
+
+/*
+ * sairSSA - Troca o codigo do contexto pelo da forma SSA, sem os phis, e
+ * refaz o grafo de fluxo. Cada versao volta ao nome da local: vale porque
+ * as versoes de uma local nunca estao vivas ao mesmo tempo (o que a
+ * construcao e a propagacao de constantes preservam). Um argumento de phi
+ * que nao e versao da mesma local vira uma copia no fim do predecessor.
+ * Cada bloco da forma SSA passa a apontar para o seu bloco no grafo novo.
+ */
+void sairSSA(struct ContextoCompilador *ctx);
+
+/* Depois de sairSSA: os blocos levam o numero do grafo de fluxo refeito */
+void imprimirSSA(const FormaSSA *ssa, const TabelaAtomos *atomos, Saida *saida);
+
+void liberarSSA(FormaSSA *ssa);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TIPOS_H
+#define TIPOS_H
+
+#include "atomos.h"
+
+/*
+ * Tipos de dados do C-. Cada tipo e um descritor unico identificado pelo
+ * indice: comparar tipos e comparar inteiros, e o texto so aparece na
+ * impressao (tabela de simbolos e mensagens de erro).
+ */
+typedef enum {
+    TIPO_NENHUM,         /* Desconhecido (nome nao declarado, erro anterior) */
+    TIPO_INT,            /* int */
+    TIPO_VOID,           /* void */
+    TIPO_INT_VETOR,      /* int[] */
+    TIPO_VOID_VETOR,     /* void[] (declaravel, mas sem uso) */
+    NUM_TIPOS_DADO
+} TipoDado;
+
+static inline const char* nomeTipoDado(TipoDado tipo) {
+    static const char* const nomes[NUM_TIPOS_DADO] = { "", "int", "void", "int[]", "void[]" };
+    return nomes[tipo];
+}
+
+/* Tipo de um especificador (ATOMO_INT ou ATOMO_VOID), simples ou vetor */
+static inline TipoDado tipoEspecificado(Atomo base, int vetor) {
+    if (base == ATOMO_INT) return vetor ? TIPO_INT_VETOR : TIPO_INT;
+    if (base == ATOMO_VOID) return vetor ? TIPO_VOID_VETOR : TIPO_VOID;
+    return TIPO_NENHUM;
+}
+
+/* Tipo de um elemento de vetor (TIPO_NENHUM se 'tipo' nao for vetor) */
+static inline TipoDado tipoElemento(TipoDado tipo) {
+    if (tipo == TIPO_INT_VETOR) return TIPO_INT;
+    if (tipo == TIPO_VOID_VETOR) return TIPO_VOID;
+    return TIPO_NENHUM;
+}
+
+#endif
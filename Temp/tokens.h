@@ -0,0 +1,117 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "saida.h"
+
+/* Tipos de token (cabem em um byte na tabela de tokens) */
+typedef enum {
+    TK_IF, TK_ELSE, TK_WHILE, TK_RETURN, TK_INT, TK_VOID,
+    TK_IGUAL, TK_DIFERENTE, TK_MENORIGUAL, TK_MAIORIGUAL, TK_MENOR, TK_MAIOR,
+    TK_ATRIBUICAO, TK_MAIS, TK_MENOS, TK_VEZES, TK_DIVIDIDO,
+    TK_PONTOVIRGULA, TK_VIRGULA, TK_ABREPARENTESES, TK_FECHAPARENTESES,
+    TK_ABRECOLCHETE, TK_FECHACOLCHETE, TK_ABRECHAVE, TK_FECHACHAVE,
+    TK_ID, TK_NUM
+} TipoToken;
+
+/*
+ * Ouvintes do scanner: chamados a cada token ou erro lexico reconhecido.
+ * Sem ouvinte instalado (NULL), nada e gravado.
+ */
+typedef void (*OuvinteToken)(void *dados, TipoToken tipo, const char *lexema,
+                             uint32_t inicio, uint32_t tamanho, int linha);
+
+typedef void (*OuvinteErroLexico)(void *dados, const char *caractere, int linha);
+
+/*
+ * Tabela de tokens em estrutura de arrays: cada token guarda apenas o tipo,
+ * o deslocamento e o tamanho do lexema no texto-fonte. Lexema e linha sao
+ * reconstruidos sob demanda na impressao.
+ */
+typedef struct {
+    unsigned char *tipos;     /* TipoToken de cada token */
+    uint32_t *inicios;        /* Deslocamento do lexema no texto-fonte */
+    uint32_t *tamanhos;       /* Comprimento do lexema */
+} TabelaTokens;
+
+/* Tabela de erros léxicos */
+typedef struct {
+    int numero;           /* Número do erro */
+    char caractere[10];   /* Caractere inválido */
+    int linhaErro;        /* Linha onde ocorreu */
+} ErroLexico;
+
+/* Estado do scanner de uma compilacao (guardado no contexto) */
+typedef struct {
+    /* Texto-fonte em memoria e posicao do scanner dentro dele */
+    const char *texto_fonte;
+    uint32_t posicao_fonte;
+    uint32_t inicio_token;
+    int linha;
+
+    /* Ouvintes instalados (NULL = gravacao desligada, custo de um teste por token) */
+    OuvinteToken ouvinte_token;
+    void *dados_ouvinte_token;
+    OuvinteErroLexico ouvinte_erro;
+    void *dados_ouvinte_erro;
+
+    TabelaTokens tabela_tokens;
+    int total_tokens;
+    int capacidade_tokens;
+
+    ErroLexico *tabela_erros_lexicos;
+    int total_erros_lexicos;
+    int capacidade_erros;
+} EstadoLexico;
+
+/* Estado vazio, pronto para uso */
+#define ESTADO_LEXICO_INICIAL { NULL, 0, 0, 1, NULL, NULL, NULL, NULL, \
+                                { NULL, NULL, NULL }, 0, 100, NULL, 0, 50 }
+
+/* Cabecalho das colunas da tabela de tokens (tabela e fluxo) */
+#define CABECALHO_TOKENS "Num      Tipo                 Lexema                         Linha     \n"
+
+/* Estado do ouvinte que escreve os tokens direto num arquivo */
+typedef struct {
+    Saida *saida;         /* Destino das linhas */
+    int total;            /* Tokens escritos ate agora */
+} FluxoTokens;
+
+const char* nomeTipoToken(TipoToken tipo);
+
+void definirOuvinteTokens(EstadoLexico *lex, OuvinteToken ouvinte, void *dados);
+
+void definirOuvinteErrosLexicos(EstadoLexico *lex, OuvinteErroLexico ouvinte, void *dados);
+
+/* Ouvinte que acumula a tabela de tokens (dados = EstadoLexico*) */
+void ouvinteTabelaTokens(void *dados, TipoToken tipo, const char *lexema,
+                         uint32_t inicio, uint32_t tamanho, int linha);
+
+/* Ouvinte que escreve cada token assim que ele e reconhecido (dados = FluxoTokens*) */
+void ouvinteFluxoTokens(void *dados, TipoToken tipo, const char *lexema,
+                        uint32_t inicio, uint32_t tamanho, int linha);
+
+/* Ouvinte que acumula a tabela de erros lexicos (dados = EstadoLexico*) */
+void ouvinteTabelaErros(void *dados, const char *caractere, int linha);
+
+void imprimirTabelaTokens(const EstadoLexico *lex, Saida *saida);
+
+/* Memoria reservada pela tabela de tokens (--emit=stats) */
+void imprimirEstatisticasTokens(const EstadoLexico *lex, Saida *saida);
+
+void resetarTabelaTokens(EstadoLexico *lex);
+
+void imprimirErrosLexicos(const EstadoLexico *lex, FILE *destino);
+
+void resetarErrosLexicos(EstadoLexico *lex);
+
+/* O scanner reentrante fica em ctx->scanner */
+struct ContextoCompilador;
+
+void iniciarScannerEmMemoria(struct ContextoCompilador *ctx, char *texto, size_t tamanho);
+
+void finalizarScanner(struct ContextoCompilador *ctx);
+
+#endif